@@ -87,8 +87,9 @@ auto co_main(config cfg) -> net::awaitable<void>
    auto conn = std::make_shared<connection>(ex);
    net::co_spawn(ex, stream_reader(conn), net::detached);
 
-   // Disable health checks.
-   cfg.health_check_interval = std::chrono::seconds::zero();
+   // XREAD BLOCK runs on a side connection so that it does not hold
+   // back other requests on conn.
+   cfg.blocking_connections = 1;
    conn->async_run(cfg, {}, net::consign(net::detached, conn));
 
    signal_set sig_set(ex, SIGINT, SIGTERM);
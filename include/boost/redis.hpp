@@ -10,6 +10,14 @@
 #include <boost/redis/config.hpp>
 #include <boost/redis/error.hpp>
 #include <boost/redis/connection.hpp>
+#include <boost/redis/replicated_connection.hpp>
+#include <boost/redis/scanner.hpp>
+#include <boost/redis/bulk_loader.hpp>
+#include <boost/redis/splitter.hpp>
+#include <boost/redis/write_behind.hpp>
+#include <boost/redis/script.hpp>
+#include <boost/redis/subscriber.hpp>
+#include <boost/redis/fan_out.hpp>
 #include <boost/redis/request.hpp>
 #include <boost/redis/response.hpp>
 #include <boost/redis/ignore.hpp>
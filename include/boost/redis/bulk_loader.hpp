@@ -0,0 +1,246 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_BULK_LOADER_HPP
+#define BOOST_REDIS_BULK_LOADER_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/detail/helper.hpp>
+#include <boost/redis/detail/bulk_error_collector.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+template <class Loader, class Generator>
+struct bulk_load_op {
+   Loader* loader_ = nullptr;
+   Generator gen_;
+   bool exhausted_ = false;
+   bool cancelled_ = false;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code = {})
+   {
+      BOOST_ASIO_CORO_REENTER (coro_) for (;;)
+      {
+         if (!cancelled_ && is_cancelled(self)) {
+            // Unwritten chunks are removed and written ones abandoned,
+            // the operation completes once all of them are back.
+            cancelled_ = true;
+            self.get_cancellation_state().clear();
+            loader_->cancel_chunks();
+         }
+
+         if (!cancelled_ && !exhausted_ && !loader_->ec_)
+            exhausted_ = !loader_->start_chunks(gen_);
+
+         if (loader_->in_flight_ == 0) {
+            if (cancelled_)
+               self.complete(asio::error::operation_aborted, loader_->responses_);
+            else
+               self.complete(loader_->ec_, loader_->responses_);
+            return;
+         }
+
+         BOOST_ASIO_CORO_YIELD
+         loader_->timer_.async_wait(std::move(self));
+      }
+   }
+};
+
+} // detail
+
+/** @brief Loads large amounts of commands with bounded memory.
+ *  @ingroup high-level-api
+ *
+ *  Commands are serialized into chunks of about
+ *  `chunk_size` bytes of which at most `window` are in flight at
+ *  any time. Chunk requests are reused, so memory stays flat
+ *  regardless of the number of commands. Responses are not stored:
+ *  only errors are collected together with the index of the response
+ *  in the load, similar to `redis-cli --pipe`.
+ *
+ *  The loader must outlive the operation.
+ *
+ *  @tparam Connection `boost::redis::connection` or `boost::redis::basic_connection`.
+ */
+template <class Connection>
+class basic_bulk_loader {
+public:
+   /// Executor type.
+   using executor_type = typename Connection::executor_type;
+
+   /// An error response and the index of the response in the load.
+   using error_type = std::pair<std::size_t, std::string>;
+
+   /** @brief Constructor.
+    *
+    *  @param conn The connection, must outlive the loader.
+    *  @param chunk_size Approximate size in bytes of each chunk.
+    *  @param window Maximum number of chunks in flight.
+    */
+   explicit
+   basic_bulk_loader(
+      Connection& conn,
+      std::size_t chunk_size = 64 * 1024,
+      std::size_t window = 8)
+   : conn_{&conn}
+   , timer_{conn.get_executor()}
+   , chunk_size_{(std::max)(chunk_size, std::size_t{1})}
+   , chunks_((std::max)(window, std::size_t{1}))
+   {
+      timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+
+      // Bulk loads should not delay interactive requests.
+      for (auto& c : chunks_) {
+         c.req.get_config().priority = request_priority::batch;
+         c.req.get_config().cancel_if_unresponded = true;
+      }
+   }
+
+   /** @brief Loads the commands produced by a generator.
+    *
+    *  @param gen Callable with signature `bool(request&)` that pushes
+    *  one or more commands into the request and returns false once
+    *  there are no more commands. It is called again until the chunk
+    *  is full.
+    *  @param token Completion token.
+    *
+    *  The completion token must have the following signature
+    *
+    *  @code
+    *  void f(system::error_code, std::size_t);
+    *  @endcode
+    *
+    *  Where the second parameter is the number of responses read.
+    *  Error responses don't fail the operation, see `get_errors`.
+    */
+   template <
+      class Generator,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto async_load(Generator gen, CompletionToken&& token = CompletionToken{})
+   {
+      errors_.clear();
+      sent_ = 0;
+      responses_ = 0;
+      ec_ = {};
+
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::bulk_load_op<basic_bulk_loader, Generator>{this, std::move(gen)}, token, timer_);
+   }
+
+   /// Returns the errors of the last load.
+   auto const& get_errors() const noexcept
+      { return errors_; }
+
+private:
+   template <class, class> friend struct detail::bulk_load_op;
+
+   using timer_type =
+      asio::basic_waitable_timer<
+         std::chrono::steady_clock,
+         asio::wait_traits<std::chrono::steady_clock>,
+         executor_type>;
+
+   struct chunk {
+      request req;
+      detail::bulk_error_collector collector;
+      asio::cancellation_signal signal;
+      bool in_flight = false;
+   };
+
+   // Fills and sends all free chunks, returns false when the
+   // generator is exhausted.
+   template <class Generator>
+   bool start_chunks(Generator& gen)
+   {
+      bool more = true;
+      for (auto& c : chunks_) {
+         if (c.in_flight)
+            continue;
+
+         c.req.clear();
+         while (more && std::size(c.req.payload()) < chunk_size_)
+            more = gen(c.req);
+
+         if (c.req.get_commands() != 0)
+            start_chunk(c);
+
+         if (!more)
+            return false;
+      }
+
+      return true;
+   }
+
+   void start_chunk(chunk& c)
+   {
+      c.collector.first = sent_;
+      c.collector.errors = &errors_;
+      sent_ += c.req.get_expected_responses();
+      c.in_flight = true;
+      ++in_flight_;
+
+      auto f = [this, &c](system::error_code ec, std::size_t)
+      {
+         c.in_flight = false;
+         --in_flight_;
+         if (ec) {
+            if (!ec_)
+               ec_ = ec;
+         } else {
+            responses_ += c.req.get_expected_responses();
+         }
+
+         timer_.cancel();
+      };
+
+      conn_->async_exec(c.req, c.collector, asio::bind_cancellation_slot(c.signal.slot(), f));
+   }
+
+   void cancel_chunks()
+   {
+      for (auto& c : chunks_) {
+         if (c.in_flight)
+            c.signal.emit(asio::cancellation_type::terminal);
+      }
+   }
+
+   Connection* conn_;
+   timer_type timer_;
+   std::size_t chunk_size_;
+   std::vector<chunk> chunks_;
+   std::vector<error_type> errors_;
+   std::size_t sent_ = 0;
+   std::size_t responses_ = 0;
+   std::size_t in_flight_ = 0;
+   system::error_code ec_;
+};
+
+/// A bulk loader that uses `boost::redis::connection`.
+using bulk_loader = basic_bulk_loader<connection>;
+
+} // boost::redis
+
+#endif // BOOST_REDIS_BULK_LOADER_HPP
@@ -7,9 +7,12 @@
 #ifndef BOOST_REDIS_CONFIG_HPP
 #define BOOST_REDIS_CONFIG_HPP
 
+#include <boost/redis/request.hpp>
+
 #include <string>
 #include <chrono>
 #include <optional>
+#include <vector>
 
 namespace boost::redis
 {
@@ -24,6 +27,113 @@ struct address {
    std::string port = "6379";
 };
 
+/** @brief Sentinel configuration
+ *  @ingroup high-level-api
+ *
+ *  See https://redis.io/docs/reference/sentinel-clients.
+ */
+struct sentinel_config {
+   /** @brief Addresses of the sentinels.
+    *
+    *  If empty, sentinels are not used and the connection connects
+    *  to `boost::redis::config::addr`.
+    */
+   std::vector<address> addresses;
+
+   /// Name of the master as known by the sentinels.
+   std::string master_name = "mymaster";
+
+   /// Username passed to `HELLO` when connecting to the sentinels.
+   std::string username = "default";
+
+   /// Password passed to `HELLO` when connecting to the sentinels.
+   std::string password;
+
+   /// Time the resolution of the master address is allowed to last.
+   std::chrono::steady_clock::duration resolve_timeout = std::chrono::seconds{10};
+};
+
+/** @brief Policy used to pick the replica a read-only request is sent to
+ *  @ingroup high-level-api
+ */
+enum class replica_selection
+{
+   /// The replica with the lowest average latency.
+   lowest_latency,
+
+   /// The replica with the fewest requests waiting for a response.
+   fewest_outstanding,
+};
+
+/** @brief Replica configuration
+ *  @ingroup high-level-api
+ *
+ *  Used by `boost::redis::basic_replicated_connection` only.
+ */
+struct replica_config {
+   /// Addresses of the replicas.
+   std::vector<address> addresses;
+
+   /** @brief Sends `READONLY` after the handshake with a replica.
+    *
+    *  Required only for replicas in a Redis Cluster.
+    */
+   bool send_readonly = false;
+
+   /// Policy used to pick a replica.
+   replica_selection selection = replica_selection::lowest_latency;
+
+   /** @brief Latency percentile after which a hedged request is duplicated.
+    *
+    *  See `boost::redis::basic_replicated_connection::async_exec_hedged`.
+    */
+   double hedge_percentile = 0.95;
+
+   /// Minimum time to wait before duplicating a hedged request.
+   std::chrono::steady_clock::duration hedge_min_delay = std::chrono::milliseconds{1};
+
+   /** @brief Number of latency samples a connection needs before its requests are hedged.
+    *
+    *  Until then the latency distribution is not known and hedged
+    *  requests are not duplicated.
+    */
+   std::size_t hedge_min_samples = 100;
+};
+
+/** @brief What `async_exec` does when the request queue is full
+ *  @ingroup high-level-api
+ *
+ *  See `boost::redis::config::max_queued_requests`.
+ */
+enum class queue_full_action
+{
+   /// Suspends the caller until enough responses arrive.
+   suspend,
+
+   /// Completes immediately with `boost::redis::error::queue_full`.
+   fail,
+};
+
+/** @brief What the connection does with pushes nobody is receiving
+ *  @ingroup high-level-api
+ *
+ *  See `boost::redis::config::push_backlog`.
+ */
+enum class push_backlog_policy
+{
+   /// Stops reading until `async_receive` is called, which also delays responses.
+   block,
+
+   /// Discards the oldest pending push to make room for a new one.
+   drop_oldest,
+
+   /// Discards new pushes while the backlog is full.
+   drop_newest,
+
+   /// Keeps only the latest message per pubsub kind, pattern and channel, otherwise as `drop_oldest`.
+   conflate,
+};
+
 /** @brief Configure parameters used by the connection classes
  *  @ingroup high-level-api
  */
@@ -34,6 +144,24 @@ struct config {
    /// Address of the Redis server.
    address addr = address{"127.0.0.1", "6379"};
 
+   /** @brief Sentinel configuration.
+    *
+    *  When sentinel addresses are provided the connection queries
+    *  them in parallel for the address of the master before each
+    *  (re)connection and watches `+switch-master` events so that a
+    *  failover triggers an immediate reconnection to the new master.
+    *  In this case `addr` is overwritten with the resolved address.
+    */
+   sentinel_config sentinel;
+
+   /** @brief Replica configuration.
+    *
+    *  Used by `boost::redis::basic_replicated_connection` to route
+    *  read-only requests to replicas, see
+    *  `boost::redis::request::is_read_only`.
+    */
+   replica_config replicas;
+
    /** @brief Username passed to the
     * [HELLO](https://redis.io/commands/hello/) command.  If left
     * empty `HELLO` will be sent without authentication parameters.
@@ -52,6 +180,18 @@ struct config {
    /// Database that will be passed to the [SELECT](https://redis.io/commands/hello/) command.
    std::optional<int> database_index = 0;
 
+   /** @brief Commands sent on every (re)connection.
+    *
+    *  These commands are pipelined in the same write as `HELLO` and
+    *  `SELECT` and are therefore executed before any other request,
+    *  without costing additional round trips. Typical examples are
+    *  `CLIENT TRACKING`, `CLIENT NO-EVICT`, `READONLY` and `SCRIPT
+    *  LOAD`. Errors are reported through `boost::redis::logger::on_hello`
+    *  and cause the connection to be closed, exactly as errors in
+    *  `HELLO`.
+    */
+   request setup{};
+
    /// Message used by the health-checker in `boost::redis::connection::async_run`.
    std::string health_check_id = "Boost.Redis";
 
@@ -75,9 +215,167 @@ struct config {
 
    /** @brief Time waited before trying a reconnection.
     *  
-    *  To disable reconnection pass zero as duration.
+    *  To disable reconnection pass zero as duration. This is also
+    *  the initial value of the exponential backoff that is applied
+    *  when consecutive reconnection attempts fail.
     */
    std::chrono::steady_clock::duration reconnect_wait_interval = std::chrono::seconds{1};
+
+   /** @brief Time waited before the first reconnection attempt after
+    *  a healthy connection is lost.
+    *
+    *  A connection is considered healthy if the `HELLO` handshake
+    *  completed successfully. This makes it possible to recover
+    *  quickly from short disruptions, e.g. a server restart.
+    */
+   std::chrono::steady_clock::duration reconnect_first_wait_interval = std::chrono::milliseconds{100};
+
+   /// Upper bound of the exponential reconnection backoff.
+   std::chrono::steady_clock::duration reconnect_max_wait_interval = std::chrono::seconds{30};
+
+   /// Factor by which the reconnection wait interval grows after each failed attempt.
+   double reconnect_backoff_factor = 2.0;
+
+   /** @brief Randomization of the reconnection wait interval.
+    *
+    *  A random fraction in the range `[0, reconnect_jitter]` of each
+    *  wait interval is subtracted from it so that many clients don't
+    *  reconnect at the same time. Must be in the range `[0, 1]`.
+    */
+   double reconnect_jitter = 0.5;
+
+   /** @brief Maximum number of bytes in flight while replaying
+    *  requests after a reconnection.
+    *
+    *  Requests that survive a connection loss (see
+    *  `boost::redis::request::config`) are written in chunks after the
+    *  connection is reestablished so that no more than this number of
+    *  bytes is written but not yet responded. Pass zero to write them
+    *  all at once.
+    */
+   std::size_t replay_max_bytes_in_flight = 256 * 1024;
+
+   /** @brief Maximum time a write is held to coalesce more requests.
+    *
+    *  When requests are waiting for responses and new ones arrive,
+    *  the connection waits up to this interval for more requests
+    *  before writing, so that they share a single write. The write
+    *  happens immediately when the connection is idle i.e. no
+    *  response is pending, or when the limits below are reached.
+    *  Pass zero to write as soon as possible (the default).
+    */
+   std::chrono::steady_clock::duration write_coalesce_interval = std::chrono::steady_clock::duration::zero();
+
+   /// Number of bytes waiting to be written that ends the coalescing window.
+   std::size_t write_coalesce_max_bytes = 16 * 1024;
+
+   /// Number of requests waiting to be written that ends the coalescing window.
+   std::size_t write_coalesce_max_requests = 64;
+
+   /** @brief Maximum number of requests in the queue of the connection.
+    *
+    *  Counts requests waiting to be written and requests waiting for
+    *  a response. When reached, `async_exec` behaves as specified in
+    *  `on_queue_full`. Requests issued internally by the connection
+    *  (`HELLO` and health-checks) are not limited. The requests of
+    *  `async_exec_batch` are admitted together, when all of them fit.
+    *  Pass zero for no limit (the default).
+    */
+   std::size_t max_queued_requests = 0;
+
+   /** @brief Maximum number of request bytes in the queue of the connection.
+    *
+    *  Same as `max_queued_requests` but limits the sum of the payload
+    *  sizes. A request larger than the limit is accepted when the
+    *  queue is empty. Pass zero for no limit (the default).
+    */
+   std::size_t max_queued_bytes = 0;
+
+   /// Action taken by `async_exec` when one of the limits above is reached.
+   queue_full_action on_queue_full = queue_full_action::suspend;
+
+   /** @brief Adapts the pipeline depth to the observed latency.
+    *
+    *  When `true`, the number of requests written but not yet
+    *  responded is limited. The limit grows while the latency of
+    *  requests stays within `pipeline_latency_tolerance` times the
+    *  lowest latency observed and shrinks otherwise. Requests above
+    *  the limit wait in the queue.
+    */
+   bool adaptive_pipeline = false;
+
+   /// Lower bound (and initial value) of the adaptive pipeline depth.
+   std::size_t min_pipeline_depth = 4;
+
+   /// Upper bound of the adaptive pipeline depth.
+   std::size_t max_pipeline_depth = 1024;
+
+   /// Tolerated latency as a multiple of the lowest latency observed.
+   double pipeline_latency_tolerance = 2.0;
+
+   /** @brief Maximum number of bytes of batch requests per write.
+    *
+    *  Limits the share of each write taken by requests with
+    *  `boost::redis::request_priority::batch` so that interactive
+    *  requests arriving meanwhile don't have to wait for a large
+    *  write. At least one batch request is written at a time.
+    */
+   std::size_t batch_max_bytes_per_write = 64 * 1024;
+
+   /** @brief Maximum number of side connections for blocking commands.
+    *
+    *  Responses arrive in order, so a blocking command such as
+    *  `BLPOP` or `XREAD BLOCK` delays every request written after it.
+    *  When this value is not zero, requests for which
+    *  `boost::redis::request::is_blocking` returns true are executed
+    *  on side connections instead, which are opened on demand up to
+    *  this number and use the same configuration as the main
+    *  connection except that health checks are disabled. Zero
+    *  disables this feature.
+    */
+   std::size_t blocking_connections = 0;
+
+   /** @brief Maximum number of reads fused into a single command.
+    *
+    *  Requests that consist of a single `GET` and are written
+    *  together are sent as one `MGET`, and so are those consisting
+    *  of a single `HGET` on the same key as one `HMGET`. The response
+    *  is split among the requests, which saves the server a command
+    *  per request. Notice that `GET` on a key that does not hold a
+    *  string responds with null instead of an error when fused. Values
+    *  smaller than two disable this feature (the default).
+    */
+   std::size_t read_fusion_max_requests = 0;
+
+   /** @brief Deduplicates identical read-only requests.
+    *
+    *  When a read-only request is executed while an identical one
+    *  (same payload) is in the queue and none of its responses has
+    *  been read yet, the new request is not written but receives a
+    *  copy of the responses to the other. Requests are only
+    *  deduplicated if their cancellation settings agree. A request
+    *  that follows another one also shares its fate e.g. it fails if
+    *  the other times out.
+    */
+   bool single_flight = false;
+
+   /** @brief Handling of pushes that arrive faster than they are received.
+    *
+    *  With `push_backlog_policy::block` (the default) pushes are
+    *  parsed directly into the receive response and the reader waits
+    *  for `async_receive` once too many are pending, so a slow
+    *  consumer delays the responses to all requests. The other
+    *  policies store pending pushes in a backlog of at most
+    *  `max_push_backlog` entries instead, which is bounded by
+    *  discarding pushes, and the reader never waits. Pushes are then
+    *  adapted into the receive response when `async_receive`
+    *  delivers them. Discarded pushes are counted in
+    *  `boost::redis::usage::pushes_dropped`.
+    */
+   push_backlog_policy push_backlog = push_backlog_policy::block;
+
+   /// Maximum number of pushes in the backlog, see `push_backlog`.
+   std::size_t max_push_backlog = 256;
 };
 
 } // boost::redis
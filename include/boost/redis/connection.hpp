@@ -8,17 +8,24 @@
 #define BOOST_REDIS_CONNECTION_HPP
 
 #include <boost/redis/detail/connection_base.hpp>
+#include <boost/redis/detail/backoff.hpp>
+#include <boost/redis/detail/sentinel.hpp>
 #include <boost/redis/logger.hpp>
 #include <boost/redis/config.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/coroutine.hpp>
+#include <boost/asio/experimental/parallel_group.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/any_completion_handler.hpp>
 
+#include <array>
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <limits>
+#include <string>
+#include <vector>
 
 namespace boost::redis {
 namespace detail
@@ -29,13 +36,50 @@ struct reconnection_op {
    Logger logger_;
    asio::coroutine coro_{};
 
+   // Whether HELLO completed in the current attempt, the flag of the
+   // runner still refers to the previous one if the attempt fails
+   // before running.
+   bool healthy_ = false;
+
+   template <class Self>
+   void operator()(Self& self, std::array<std::size_t, 2> order, system::error_code ec0, system::error_code)
+   {
+      // Completion of the run operation in parallel with the sentinel
+      // watcher, only the run error is relevant.
+      ignore_unused(order);
+      (*this)(self, ec0);
+   }
+
    template <class Self>
    void operator()(Self& self, system::error_code ec = {})
    {
       BOOST_ASIO_CORO_REENTER (coro_) for (;;)
       {
-         BOOST_ASIO_CORO_YIELD
-         conn_->impl_.async_run(conn_->cfg_, logger_, std::move(self));
+         healthy_ = false;
+         if (conn_->use_sentinel() && !conn_->sentinel_->take_failover(conn_->cfg_.addr)) {
+            BOOST_ASIO_CORO_YIELD
+            conn_->sentinel_->async_resolve_master(conn_->cfg_, logger_, std::move(self));
+            if (!ec)
+               conn_->cfg_.addr = conn_->sentinel_->get_master_address();
+         }
+
+         if (!ec) {
+            if (conn_->use_sentinel()) {
+               BOOST_ASIO_CORO_YIELD
+               asio::experimental::make_parallel_group(
+                  [c = conn_, l = logger_](auto token) { return c->impl_.async_run(c->cfg_, l, token); },
+                  [c = conn_, l = logger_](auto token) { return c->sentinel_->async_watch(*c, c->cfg_, l, token); }
+               ).async_wait(
+                  asio::experimental::wait_for_one(),
+                  std::move(self));
+            } else {
+               BOOST_ASIO_CORO_YIELD
+               conn_->impl_.async_run(conn_->cfg_, logger_, std::move(self));
+            }
+
+            healthy_ = conn_->impl_.has_completed_hello();
+         }
+
          conn_->cancel(operation::receive);
          logger_.on_connection_lost(ec);
          if (!conn_->will_reconnect() || is_cancelled(self)) {
@@ -44,10 +88,15 @@ struct reconnection_op {
             return;
          }
 
-         conn_->timer_.expires_after(conn_->cfg_.reconnect_wait_interval);
-         BOOST_ASIO_CORO_YIELD
-         conn_->timer_.async_wait(std::move(self));
-         BOOST_REDIS_CHECK_OP0(;)
+         // After a failover the new master is known to be up, there is
+         // no reason to wait.
+         if (!conn_->use_sentinel() || !conn_->sentinel_->has_failover()) {
+            conn_->timer_.expires_after(conn_->backoff_.next_wait(healthy_));
+            BOOST_ASIO_CORO_YIELD
+            conn_->timer_.async_wait(std::move(self));
+            BOOST_REDIS_CHECK_OP0(;)
+         }
+
          if (!conn_->will_reconnect()) {
             self.complete(asio::error::operation_aborted);
             return;
@@ -100,6 +149,7 @@ public:
       std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)())
    : impl_{ex, std::move(ctx), max_read_size}
    , timer_{ex}
+   , max_read_size_{max_read_size}
    { }
 
    /// Contructs from a context.
@@ -111,13 +161,36 @@ public:
    : basic_connection(ioc.get_executor(), std::move(ctx), max_read_size)
    { }
 
+   /** @brief Constructor with a shared SSL context.
+    *
+    *  @param ex Executor on which connection operation will run.
+    *  @param ctx SSL context, shared with other connections e.g.
+    *  obtained with `share_ssl_context`.
+    *  @param max_read_size Maximum read size that is passed to
+    *  the internal `asio::dynamic_buffer` constructor.
+    */
+   basic_connection(
+      executor_type ex,
+      std::shared_ptr<asio::ssl::context> ctx,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)())
+   : impl_{ex, std::move(ctx), max_read_size}
+   , timer_{ex}
+   , max_read_size_{max_read_size}
+   { }
+
    /** @brief Starts underlying connection operations.
     *
     *  This member function provides the following functionality
     *
-    *  1. Resolve the address passed on `boost::redis::config::addr`.
+    *  1. Resolve the address passed on `boost::redis::config::addr`
+    *     or, when `boost::redis::config::sentinel` contains addresses,
+    *     ask the sentinels for the address of the master. In this
+    *     mode a connection to one of the sentinels is kept subscribed
+    *     to `+switch-master` so that a failover triggers an immediate
+    *     reconnection to the new master.
     *  2. Connect to one of the results obtained in the resolve operation.
-    *  3. Send a [HELLO](https://redis.io/commands/hello/) command where each of its parameters are read from `cfg`.
+    *  3. Send a [HELLO](https://redis.io/commands/hello/) command where each of its parameters are read from `cfg`,
+    *     pipelined with the commands in `boost::redis::config::setup`.
     *  4. Start a health-check operation where ping commands are sent
     *     at intervals specified in
     *     `boost::redis::config::health_check_interval`.  The message passed to
@@ -131,9 +204,19 @@ public:
     *  requests i.e. calls to `async_exec` that happened prior to this
     *  call.
     *
+    *  When `boost::redis::config::blocking_connections` is not zero,
+    *  side connections for blocking commands are started as well
+    *  when the first such request is executed.
+    *
     *  When a connection is lost for any reason, a new one is
     *  stablished automatically. To disable reconnection call
     *  `boost::redis::connection::cancel(operation::reconnection)`.
+    *  Consecutive failed reconnection attempts are spaced by a
+    *  randomized exponential backoff, see
+    *  `boost::redis::config::reconnect_wait_interval` and the
+    *  parameters that follow it. Requests that survived the
+    *  connection loss are replayed in chunks of at most
+    *  `boost::redis::config::replay_max_bytes_in_flight` bytes.
     *
     *  @param cfg Configuration paramters.
     *  @param l Logger object. The interface expected is specified in the class `boost::redis::logger`.
@@ -160,6 +243,22 @@ public:
       using this_type = basic_connection<executor_type>;
 
       cfg_ = cfg;
+      backoff_.set_config(cfg_);
+      backoff_.reset();
+      if (use_sentinel() && !sentinel_)
+         sentinel_ = std::make_unique<detail::sentinel<executor_type>>(get_executor());
+
+      // Side connections are started on demand with the same logger.
+      // Those of a previous run keep themselves alive until they
+      // complete.
+      for (auto const& conn : blocking_conns_)
+         conn->cancel();
+      blocking_conns_.clear();
+      start_blocking_ = [l](std::shared_ptr<this_type> const& conn, config const& c)
+      {
+         conn->async_run(c, l, [conn](system::error_code) {});
+      };
+
       l.set_prefix(cfg_.log_prefix);
       return asio::async_compose
          < CompletionToken
@@ -172,7 +271,9 @@ public:
     *  When pushes arrive and there is no `async_receive` operation in
     *  progress, pushed data, requests, and responses will be paused
     *  until `async_receive` is called again.  Apps will usually want
-    *  to call `async_receive` in a loop. 
+    *  to call `async_receive` in a loop. Unless a backlog policy is
+    *  set in `boost::redis::config::push_backlog`, in which case
+    *  pending pushes are stored (or discarded) and reading continues.
     *
     *  To cancel an ongoing receive operation apps should call
     *  `connection::cancel(operation::receive)`.
@@ -256,7 +357,82 @@ public:
       Response& resp = ignore,
       CompletionToken&& token = CompletionToken{})
    {
-      return impl_.async_exec(req, resp, std::forward<CompletionToken>(token));
+      if (cfg_.blocking_connections == 0 || !req.is_blocking())
+         return impl_.async_exec(req, resp, std::forward<CompletionToken>(token));
+
+      return get_blocking_connection().impl_.async_exec(req, resp, std::forward<CompletionToken>(token));
+   }
+
+   /** @brief Executes a request passing each response to a callback as soon as it arrives.
+    *
+    *  Works like `async_exec` but instead of filling a response
+    *  object, the response to each command is passed to `cb` as soon
+    *  as it has been read, while the responses that follow are still
+    *  arriving. The memory used by a response is reused for the next
+    *  one, so large pipelines don't have to be held in memory.
+    *
+    *  @param req Request.
+    *  @param cb Callback with signature `void(std::size_t i, generic_response const& resp)`
+    *  where `i` is the index of the response in the request. It is
+    *  called from within the connection and must not throw.
+    *  @param token Completion token.
+    *
+    *  The completion token must have the following signature
+    *
+    *  @code
+    *  void f(system::error_code, std::size_t);
+    *  @endcode
+    */
+   template <
+      class Callback,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec_progressive(
+      request const& req,
+      Callback cb,
+      CompletionToken&& token = CompletionToken{})
+   {
+      return impl_.async_exec_progressive(req, std::move(cb), std::forward<CompletionToken>(token));
+   }
+
+   /** @brief Executes many requests with a single completion.
+    *
+    *  Equivalent to calling `async_exec` for each request, but all
+    *  requests are added to the queue in one step and the operation
+    *  completes once, after all of them completed. This avoids the
+    *  cost of one operation and completion per request.
+    *
+    *  @param reqs Requests.
+    *  @param resps Responses, `resps[i]` receives the response to `reqs[i]`.
+    *  @param results `results[i]` is set to the error of `reqs[i]`, if any.
+    *  @param token Completion token.
+    *
+    *  The three spans must have the same size and refer to objects
+    *  that outlive the operation. The completion token must have the
+    *  following signature
+    *
+    *  @code
+    *  void f(system::error_code, std::size_t);
+    *  @endcode
+    *
+    *  Where the error is set only if the operation as a whole failed
+    *  e.g. it was cancelled, and the second parameter is the total
+    *  size of the responses. Requests are always executed on this
+    *  connection, see `boost::redis::config::blocking_connections`.
+    */
+   template <
+      class Response = ignore_t,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec_batch(
+      span<request const* const> reqs,
+      span<Response* const> resps,
+      span<system::error_code> results,
+      CompletionToken&& token = CompletionToken{})
+   {
+      return impl_.async_exec_batch(reqs, resps, results, std::forward<CompletionToken>(token));
    }
 
    /** @brief Cancel operations.
@@ -277,10 +453,19 @@ public:
          case operation::all:
             cfg_.reconnect_wait_interval = std::chrono::seconds::zero();
             timer_.cancel();
+            if (sentinel_)
+               sentinel_->cancel();
             break;
          default: /* ignore */;
       }
 
+      // Side connections reconnect on their own, see
+      // config::blocking_connections.
+      if (op != operation::run && op != operation::receive) {
+         for (auto const& conn : blocking_conns_)
+            conn->cancel(op);
+      }
+
       impl_.cancel(op);
    }
 
@@ -292,6 +477,10 @@ public:
    auto const& get_ssl_context() const noexcept
       { return impl_.get_ssl_context();}
 
+   /// Returns the ssl context to share it with other connections.
+   auto share_ssl_context() const noexcept
+      { return impl_.share_ssl_context();}
+
    /// Resets the underlying stream.
    void reset_stream()
       { impl_.reset_stream(); }
@@ -309,10 +498,41 @@ public:
    void set_receive_response(Response& response)
       { impl_.set_receive_response(response); }
 
+   /** @brief Sets a function that adds commands to the setup request.
+    *
+    *  The function is called before every (re)connection with the
+    *  request that contains `HELLO` and `boost::redis::config::setup`,
+    *  the commands it pushes are therefore executed before any other
+    *  request. Used for example to restore subscriptions, see
+    *  `boost::redis::basic_subscriber`.
+    */
+   void set_setup_hook(std::function<void(request&)> f)
+      { impl_.set_setup_hook(std::move(f)); }
+
    /// Returns connection usage information.
    usage get_usage() const noexcept
       { return impl_.get_usage(); }
 
+   /// Returns true if the connection is established and the handshake has completed.
+   bool is_ready() const noexcept
+      { return impl_.is_ready(); }
+
+   /// Returns the smoothed average latency of requests, zero if none has completed yet.
+   auto get_average_latency() const noexcept
+      { return impl_.get_latency().get_average(); }
+
+   /// Returns an upper bound of the p-th percentile of request latencies, p in [0, 1].
+   auto get_latency_percentile(double p) const noexcept
+      { return impl_.get_latency().get_percentile(p); }
+
+   /// Returns the number of requests whose latency has been measured.
+   auto get_latency_samples() const noexcept
+      { return impl_.get_latency().get_samples(); }
+
+   /// Returns the number of requests that haven't completed yet.
+   std::size_t get_outstanding_requests() const noexcept
+      { return impl_.get_outstanding_requests(); }
+
 private:
    using timer_type =
       asio::basic_waitable_timer<
@@ -322,9 +542,46 @@ private:
 
    template <class, class> friend struct detail::reconnection_op;
 
+   bool use_sentinel() const noexcept
+      { return !std::empty(cfg_.sentinel.addresses); }
+
+   // Returns an idle side connection, opening a new one if all are
+   // busy and the limit has not been reached, otherwise the least
+   // busy.
+   auto get_blocking_connection() -> basic_connection&
+   {
+      basic_connection* best = nullptr;
+      for (auto const& conn : blocking_conns_) {
+         if (best == nullptr || conn->get_outstanding_requests() < best->get_outstanding_requests())
+            best = conn.get();
+      }
+
+      if (best != nullptr && (best->get_outstanding_requests() == 0 || std::size(blocking_conns_) >= cfg_.blocking_connections))
+         return *best;
+
+      auto cfg = cfg_;
+      cfg.blocking_connections = 0;
+      cfg.health_check_interval = std::chrono::steady_clock::duration::zero();
+      cfg.log_prefix += "(blocking " + std::to_string(std::size(blocking_conns_)) + ") ";
+
+      // Uses the ssl context of this connection, which has been set
+      // up by the user e.g. with certificates.
+      std::shared_ptr<basic_connection> conn{
+         new basic_connection{get_executor(), impl_.share_ssl_context(), max_read_size_}};
+
+      blocking_conns_.push_back(conn);
+      start_blocking_(conn, cfg);
+      return *conn;
+   }
+
    config cfg_;
    detail::connection_base<executor_type> impl_;
    timer_type timer_;
+   detail::backoff backoff_;
+   std::unique_ptr<detail::sentinel<executor_type>> sentinel_;
+   std::size_t max_read_size_;
+   std::vector<std::shared_ptr<basic_connection>> blocking_conns_;
+   std::function<void(std::shared_ptr<basic_connection> const&, config const&)> start_blocking_;
 };
 
 /** \brief A basic_connection that type erases the executor.
@@ -397,6 +654,25 @@ public:
       return impl_.async_exec(req, resp, std::move(token));
    }
 
+   /// Calls `boost::redis::basic_connection::async_exec_progressive`.
+   template <class Callback, class CompletionToken>
+   auto async_exec_progressive(request const& req, Callback cb, CompletionToken token)
+   {
+      return impl_.async_exec_progressive(req, std::move(cb), std::move(token));
+   }
+
+   /// Calls `boost::redis::basic_connection::async_exec_batch`.
+   template <class Response, class CompletionToken>
+   auto
+   async_exec_batch(
+      span<request const* const> reqs,
+      span<Response* const> resps,
+      span<system::error_code> results,
+      CompletionToken token)
+   {
+      return impl_.async_exec_batch(reqs, resps, results, std::move(token));
+   }
+
    /// Calls `boost::redis::basic_connection::cancel`.
    void cancel(operation op = operation::all);
 
@@ -421,6 +697,10 @@ public:
    void set_receive_response(Response& response)
       { impl_.set_receive_response(response); }
 
+   /// Calls `boost::redis::basic_connection::set_setup_hook`.
+   void set_setup_hook(std::function<void(request&)> f)
+      { impl_.set_setup_hook(std::move(f)); }
+
    /// Returns connection usage information.
    usage get_usage() const noexcept
       { return impl_.get_usage(); }
@@ -429,6 +709,10 @@ public:
    auto const& get_ssl_context() const noexcept
       { return impl_.get_ssl_context();}
 
+   /// Calls `boost::redis::basic_connection::share_ssl_context`.
+   auto share_ssl_context() const noexcept
+      { return impl_.share_ssl_context();}
+
 private:
    void
    async_run_impl(
@@ -0,0 +1,92 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_BACKOFF_HPP
+#define BOOST_REDIS_BACKOFF_HPP
+
+#include <boost/redis/config.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace boost::redis::detail
+{
+
+/* Computes the time to wait between reconnection attempts.
+ *
+ * The first attempt after losing a healthy connection waits
+ * config::reconnect_first_wait_interval, subsequent attempts grow
+ * exponentially from config::reconnect_wait_interval up to
+ * config::reconnect_max_wait_interval. A random fraction
+ * (config::reconnect_jitter) of each interval is subtracted so that
+ * many clients losing the connection at the same time don't
+ * reconnect in lockstep.
+ */
+class backoff {
+public:
+   using duration = std::chrono::steady_clock::duration;
+
+   backoff()
+   : engine_{std::random_device{}()}
+   { }
+
+   void set_config(config const& cfg)
+   {
+      first_ = cfg.reconnect_first_wait_interval;
+      base_ = cfg.reconnect_wait_interval;
+      max_ = (std::max)(cfg.reconnect_max_wait_interval, base_);
+      factor_ = (std::max)(cfg.reconnect_backoff_factor, 1.0);
+      jitter_ = (std::clamp)(cfg.reconnect_jitter, 0.0, 1.0);
+   }
+
+   // Returns the time to wait before the next attempt. Pass true if
+   // the connection that has just been lost was healthy i.e. the
+   // handshake completed, in which case the backoff is reset.
+   auto next_wait(bool was_healthy) -> duration
+   {
+      if (was_healthy) {
+         attempts_ = 0;
+         return apply_jitter(first_);
+      }
+
+      auto wait = std::chrono::duration<double, duration::period>{base_};
+      for (std::size_t i = 0; i < attempts_ && wait < max_; ++i)
+         wait *= factor_;
+
+      ++attempts_;
+      return apply_jitter((std::min)(std::chrono::duration_cast<duration>(wait), max_));
+   }
+
+   void reset() noexcept
+      { attempts_ = 0; }
+
+   [[nodiscard]] auto get_attempts() const noexcept
+      { return attempts_; }
+
+private:
+   auto apply_jitter(duration d) -> duration
+   {
+      if (jitter_ == 0.0 || d == duration::zero())
+         return d;
+
+      std::uniform_real_distribution<double> dist{0.0, jitter_};
+      auto const cut = std::chrono::duration<double, duration::period>{d} * dist(engine_);
+      return d - std::chrono::duration_cast<duration>(cut);
+   }
+
+   std::minstd_rand engine_;
+   duration first_{};
+   duration base_{};
+   duration max_{};
+   double factor_ = 1.0;
+   double jitter_ = 0.0;
+   std::size_t attempts_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_BACKOFF_HPP
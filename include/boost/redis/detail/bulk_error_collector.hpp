@@ -0,0 +1,72 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_BULK_ERROR_COLLECTOR_HPP
+#define BOOST_REDIS_BULK_ERROR_COLLECTOR_HPP
+
+#include <boost/redis/adapter/detail/response_traits.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+/* Response type of the chunks of a bulk load: responses are not
+ * stored, only errors with the index of the response in the load.
+ */
+struct bulk_error_collector {
+   std::size_t first = 0;
+   std::vector<std::pair<std::size_t, std::string>>* errors = nullptr;
+};
+
+class bulk_error_adapter {
+public:
+   explicit bulk_error_adapter(bulk_error_collector& c) noexcept
+   : collector_{&c}
+   { }
+
+   // Never sets ec so that an error doesn't interrupt the chunk.
+   void operator()(std::size_t i, resp3::basic_node<std::string_view> const& nd, system::error_code&)
+   {
+      if (nd.depth != 0)
+         return;
+
+      if (nd.data_type == resp3::type::simple_error || nd.data_type == resp3::type::blob_error)
+         collector_->errors->emplace_back(collector_->first + i, nd.value);
+   }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return (std::numeric_limits<std::size_t>::max)();}
+
+private:
+   bulk_error_collector* collector_;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <>
+struct response_traits<redis::detail::bulk_error_collector> {
+   using response_type = redis::detail::bulk_error_collector;
+   using adapter_type = redis::detail::bulk_error_adapter;
+
+   static auto adapt(response_type& c) noexcept
+      { return adapter_type{c}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_BULK_ERROR_COLLECTOR_HPP
@@ -0,0 +1,108 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_CONCURRENCY_LIMITER_HPP
+#define BOOST_REDIS_CONCURRENCY_LIMITER_HPP
+
+#include <boost/redis/config.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace boost::redis::detail
+{
+
+/* Adapts the number of requests that may be written but not yet
+ * responded (the pipeline depth) to the latency observed.
+ *
+ * Uses AIMD on latency: as long as the latency of a request stays
+ * within config::pipeline_latency_tolerance times the lowest latency
+ * seen, the limit grows by one per round-trip (i.e. by 1/limit per
+ * response). Otherwise it is reduced by a quarter, at most once per
+ * round-trip. The lowest latency is refreshed periodically so that
+ * the limiter follows changes in the network or server.
+ */
+class concurrency_limiter {
+public:
+   using duration = std::chrono::steady_clock::duration;
+
+   void set_config(config const& cfg)
+   {
+      enabled_ = cfg.adaptive_pipeline;
+      min_ = (std::max)(cfg.min_pipeline_depth, std::size_t{1});
+      max_ = (std::max)(cfg.max_pipeline_depth, min_);
+      tolerance_ = (std::max)(cfg.pipeline_latency_tolerance, 1.0);
+   }
+
+   void reset() noexcept
+   {
+      limit_ = static_cast<double>(min_);
+      min_latency_ = duration::max();
+      window_min_ = duration::max();
+      samples_ = 0;
+      since_decrease_ = 0;
+   }
+
+   [[nodiscard]] bool is_enabled() const noexcept
+      { return enabled_; }
+
+   // Returns the current limit, unlimited if disabled.
+   [[nodiscard]] auto get_limit() const noexcept -> std::size_t
+   {
+      if (!enabled_)
+         return (std::numeric_limits<std::size_t>::max)();
+
+      return static_cast<std::size_t>(limit_);
+   }
+
+   void on_response(duration latency) noexcept
+   {
+      if (!enabled_)
+         return;
+
+      update_min_latency(latency);
+
+      ++since_decrease_;
+      auto const threshold = std::chrono::duration<double, duration::period>{min_latency_} * tolerance_;
+      if (latency <= threshold) {
+         limit_ = (std::min)(limit_ + 1.0 / limit_, static_cast<double>(max_));
+      } else if (since_decrease_ >= get_limit()) {
+         limit_ = (std::max)(limit_ * 0.75, static_cast<double>(min_));
+         since_decrease_ = 0;
+      }
+   }
+
+private:
+   // Number of responses after which the lowest latency is replaced
+   // by the lowest latency of the last window.
+   static constexpr std::uint64_t window = 1000;
+
+   void update_min_latency(duration latency) noexcept
+   {
+      window_min_ = (std::min)(window_min_, latency);
+      min_latency_ = (std::min)(min_latency_, latency);
+      if (++samples_ % window == 0) {
+         min_latency_ = window_min_;
+         window_min_ = duration::max();
+      }
+   }
+
+   bool enabled_ = false;
+   std::size_t min_ = 1;
+   std::size_t max_ = 1;
+   double tolerance_ = 2.0;
+   double limit_ = 1.0;
+   duration min_latency_ = duration::max();
+   duration window_min_ = duration::max();
+   std::uint64_t samples_ = 0;
+   std::size_t since_decrease_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_CONCURRENCY_LIMITER_HPP
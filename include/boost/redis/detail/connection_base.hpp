@@ -14,7 +14,12 @@
 #include <boost/redis/request.hpp>
 #include <boost/redis/resp3/type.hpp>
 #include <boost/redis/config.hpp>
+#include <boost/redis/detail/concurrency_limiter.hpp>
+#include <boost/redis/detail/latency_tracker.hpp>
+#include <boost/redis/detail/push_backlog.hpp>
+#include <boost/redis/detail/read_fuser.hpp>
 #include <boost/redis/detail/runner.hpp>
+#include <boost/redis/detail/timer_wheel.hpp>
 #include <boost/redis/usage.hpp>
 
 #include <boost/system.hpp>
@@ -25,6 +30,7 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/assert.hpp>
+#include <boost/core/span.hpp>
 #include <boost/core/ignore_unused.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/read_until.hpp>
@@ -34,10 +40,14 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <type_traits>
+#include <vector>
 #include <functional>
 
 namespace boost::redis::detail
@@ -110,6 +120,7 @@ struct exec_op {
 
    Conn* conn_ = nullptr;
    std::shared_ptr<req_info_type> info_ = nullptr;
+   std::size_t exec_cancellations_ = 0;
    asio::coroutine coro{};
 
    template <class Self>
@@ -125,6 +136,27 @@ struct exec_op {
             return self.complete(error::not_connected, 0);
          }
 
+         // Backpressure, see config::max_queued_requests.
+         if (conn_->must_wait_for_queue(*info_->req_)) {
+            if (conn_->get_queue_full_action() == queue_full_action::fail) {
+               BOOST_ASIO_CORO_YIELD
+               asio::post(std::move(self));
+               return self.complete(error::queue_full, 0);
+            }
+
+            exec_cancellations_ = conn_->exec_cancellations_;
+            ++conn_->suspended_requests_;
+            do {
+               BOOST_ASIO_CORO_YIELD
+               conn_->queue_timer_.async_wait(std::move(self));
+               if (is_cancelled(self) || exec_cancellations_ != conn_->exec_cancellations_) {
+                  conn_->leave_queue_wait();
+                  return self.complete(asio::error::operation_aborted, 0);
+               }
+            } while (conn_->is_queue_full(*info_->req_));
+            conn_->leave_queue_wait();
+         }
+
          conn_->add_request_info(info_);
 
 EXEC_OP_WAIT:
@@ -132,7 +164,9 @@ EXEC_OP_WAIT:
          info_->async_wait(std::move(self));
 
          if (info_->ec_) {
-            self.complete(info_->ec_, 0);
+            auto const ec = info_->ec_;
+            conn_->recycle(std::move(info_));
+            self.complete(ec, 0);
             return;
          }
 
@@ -147,9 +181,10 @@ EXEC_OP_WAIT:
                using c_t = asio::cancellation_type;
                auto const c = self.get_cancellation_state().cancelled();
                if ((c & c_t::terminal) != c_t::none) {
-                  // Cancellation requires closing the connection
-                  // otherwise it stays in inconsistent state.
-                  conn_->cancel(operation::run);
+                  // The request stays in the queue so that its
+                  // responses are read and discarded, the connection
+                  // and other requests are not affected.
+                  conn_->abandon_request(*info_);
                   return self.complete(asio::error::operation_aborted, 0);
                } else {
                   // Can't implement other cancelation types, ignoring.
@@ -167,7 +202,116 @@ EXEC_OP_WAIT:
             }
          }
 
-         self.complete(info_->ec_, info_->read_size_);
+         {
+            auto const ec = info_->ec_;
+            auto const read_size = info_->read_size_;
+            conn_->recycle(std::move(info_));
+            self.complete(ec, read_size);
+         }
+      }
+   }
+};
+
+template <class Conn>
+struct exec_batch_op {
+   using req_info_type = typename Conn::req_info;
+   using batch_info_type = typename Conn::batch_info;
+
+   Conn* conn_ = nullptr;
+   std::shared_ptr<batch_info_type> batch_ = nullptr;
+   std::vector<std::shared_ptr<req_info_type>> infos_;
+   std::size_t bytes_ = 0;
+   std::size_t exec_cancellations_ = 0;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self , system::error_code = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         // Backpressure applies to the batch as a whole, see
+         // config::max_queued_requests.
+         for (auto const& info : infos_)
+            bytes_ += std::size(info->req_->payload());
+
+         if (!infos_.empty() && conn_->must_wait_for_queue(std::size(infos_), bytes_)) {
+            if (conn_->get_queue_full_action() == queue_full_action::fail) {
+               for (auto& ec : batch_->results_)
+                  ec = error::queue_full;
+
+               BOOST_ASIO_CORO_YIELD
+               asio::post(std::move(self));
+               return self.complete({}, 0);
+            }
+
+            exec_cancellations_ = conn_->exec_cancellations_;
+            ++conn_->suspended_requests_;
+            do {
+               BOOST_ASIO_CORO_YIELD
+               conn_->queue_timer_.async_wait(std::move(self));
+               if (is_cancelled(self) || exec_cancellations_ != conn_->exec_cancellations_) {
+                  conn_->leave_queue_wait();
+                  return self.complete(asio::error::operation_aborted, 0);
+               }
+            } while (conn_->is_queue_full(std::size(infos_), bytes_));
+            conn_->leave_queue_wait();
+         }
+
+         conn_->add_batch(infos_, *batch_);
+
+         if (batch_->pending_ == 0) {
+            BOOST_ASIO_CORO_YIELD
+            asio::post(std::move(self));
+            return self.complete({}, 0);
+         }
+
+         BOOST_ASIO_CORO_YIELD
+         batch_->notifier_.async_receive(std::move(self));
+
+         if (batch_->pending_ != 0) {
+            // Cancelled: unwritten requests are removed and written
+            // ones abandoned, see exec_op.
+            conn_->cancel_batch(infos_);
+            return self.complete(asio::error::operation_aborted, 0);
+         }
+
+         self.complete({}, batch_->read_size_);
+      }
+   }
+};
+
+// Sheds requests whose timeout expired while waiting to be written,
+// see request::config::timeout.
+template <class Conn>
+struct deadline_op {
+   Conn* conn_ = nullptr;
+   std::shared_ptr<bool> stopped_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code = {})
+   {
+      BOOST_ASIO_CORO_REENTER (coro) for (;;)
+      {
+         BOOST_ASIO_CORO_YIELD
+         conn_->deadline_timer_.async_wait(std::move(self));
+
+         // A stopped op must not touch the connection, it might have
+         // been destroyed.
+         if (*stopped_) {
+            self.complete(asio::error::operation_aborted);
+            return;
+         }
+
+         conn_->shed_expired_requests();
+
+         if (*stopped_ || conn_->deadlines_.size() == 0) {
+            conn_->stop_deadline_timer();
+            self.complete({});
+            return;
+         }
+
+         conn_->deadline_timer_.expires_at(conn_->deadlines_.next_expiry());
       }
    }
 };
@@ -228,6 +372,26 @@ struct writer_op {
 
       BOOST_ASIO_CORO_REENTER (coro) for (;;)
       {
+         // Holds the write for a while so that requests arriving
+         // shortly after share it, see config::write_coalesce_interval.
+         // The timer is notified on every new request.
+         if (conn_->start_write_hold()) {
+            while (conn_->is_holding_write()) {
+               BOOST_ASIO_CORO_YIELD
+               conn_->writer_timer_.async_wait(std::move(self));
+               if (!conn_->is_open() || is_cancelled(self)) {
+                  logger_.trace("writer-op: canceled (4). Exiting ...");
+                  self.complete({});
+                  return;
+               }
+
+               if (!ec)
+                  break; // Deadline.
+            }
+
+            conn_->writer_timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+         }
+
          while (conn_->coalesce_requests()) {
             if (conn_->use_ssl())
                BOOST_ASIO_CORO_YIELD asio::async_write(conn_->next_layer(), asio::buffer(conn_->write_buffer_), std::move(self));
@@ -347,7 +511,10 @@ struct reader_op {
          }
 
          if (res_.first == parse_result::push) {
-            if (!conn_->receive_channel_.try_send(ec, res_.second)) {
+            // With a push backlog the channel only wakes up
+            // async_receive, a full channel means it will be woken
+            // anyway.
+            if (!conn_->receive_channel_.try_send(ec, res_.second) && !conn_->backlog_.is_enabled()) {
                BOOST_ASIO_CORO_YIELD
                conn_->receive_channel_.async_send(ec, res_.second, std::move(self));
             }
@@ -370,6 +537,40 @@ struct reader_op {
    }
 };
 
+template <class Conn>
+struct receive_op {
+   Conn* conn_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro) for (;;)
+      {
+         if (conn_->backlog_.is_enabled() && !conn_->backlog_.empty()) {
+            BOOST_ASIO_CORO_YIELD
+            asio::post(std::move(self));
+            if (conn_->backlog_.empty())
+               continue;
+
+            n = conn_->deliver_push(ec);
+            self.complete(ec, n);
+            return;
+         }
+
+         BOOST_ASIO_CORO_YIELD
+         conn_->receive_channel_.async_receive(std::move(self));
+
+         // With a backlog the channel only signals that pushes are
+         // pending, they might have been delivered already.
+         if (ec || !conn_->backlog_.is_enabled()) {
+            self.complete(ec, n);
+            return;
+         }
+      }
+   }
+};
+
 /** @brief Base class for high level Redis asynchronous connections.
  *  @ingroup high-level-api
  *
@@ -396,25 +597,45 @@ public:
       executor_type ex,
       asio::ssl::context ctx,
       std::size_t max_read_size)
+   : connection_base(ex, std::make_shared<asio::ssl::context>(std::move(ctx)), max_read_size)
+   { }
+
+   /// Constructs from an executor and a context shared with other connections.
+   connection_base(
+      executor_type ex,
+      std::shared_ptr<asio::ssl::context> ctx,
+      std::size_t max_read_size)
    : ctx_{std::move(ctx)}
-   , stream_{std::make_unique<next_layer_type>(ex, ctx_)}
+   , stream_{std::make_unique<next_layer_type>(ex, *ctx_)}
    , writer_timer_{ex}
+   , queue_timer_{ex}
+   , deadline_timer_{ex}
    , receive_channel_{ex, 256}
    , runner_{ex, {}}
    , dbuf_{read_buffer_, max_read_size}
    {
       set_receive_response(ignore);
       writer_timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+      queue_timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+   }
+
+   ~connection_base()
+   {
+      stop_deadline_timer();
    }
 
    /// Returns the ssl context.
    auto const& get_ssl_context() const noexcept
+      { return *ctx_;}
+
+   /// Returns the ssl context to share it with other connections.
+   auto share_ssl_context() const noexcept
       { return ctx_;}
 
    /// Resets the underlying stream.
    void reset_stream()
    {
-      stream_ = std::make_unique<next_layer_type>(writer_timer_.get_executor(), ctx_);
+      stream_ = std::make_unique<next_layer_type>(writer_timer_.get_executor(), *ctx_);
    }
 
    /// Returns a reference to the next layer.
@@ -447,7 +668,31 @@ public:
       auto f = boost_redis_adapt(resp);
       BOOST_ASSERT_MSG(req.get_expected_responses() <= f.get_supported_response_size(), "Request and response have incompatible sizes.");
 
-      auto info = std::make_shared<req_info>(req, f, get_executor());
+      auto info = make_request_info(req, f);
+
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(exec_op<this_type>{this, info}, token, writer_timer_);
+   }
+
+   template <class Callback, class CompletionToken>
+   auto async_exec_progressive(request const& req, Callback cb, CompletionToken token)
+   {
+      using namespace boost::redis::adapter;
+
+      // Holds one response at a time, it is cleared after being
+      // passed to the callback.
+      auto resp = std::make_shared<generic_response>();
+      auto info = make_request_info(req, boost_redis_adapt(*resp));
+      info->on_response_ = [resp, cb = std::move(cb), i = std::size_t{0}]() mutable
+      {
+         cb(i++, std::as_const(*resp));
+         if (resp->has_value())
+            resp->value().clear();
+         else
+            *resp = generic_response{};
+      };
 
       return asio::async_compose
          < CompletionToken
@@ -455,17 +700,49 @@ public:
          >(exec_op<this_type>{this, info}, token, writer_timer_);
    }
 
+   template <class Response, class CompletionToken>
+   auto
+   async_exec_batch(
+      span<request const* const> reqs,
+      span<Response* const> resps,
+      span<system::error_code> results,
+      CompletionToken token)
+   {
+      using namespace boost::redis::adapter;
+      BOOST_ASSERT_MSG(std::size(reqs) == std::size(resps) && std::size(reqs) == std::size(results), "Requests, responses and results must have the same size.");
+
+      std::fill(std::begin(results), std::end(results), system::error_code{});
+
+      std::vector<std::shared_ptr<req_info>> infos;
+      infos.reserve(std::size(reqs));
+      for (std::size_t i = 0; i < std::size(reqs); ++i) {
+         auto f = boost_redis_adapt(*resps[i]);
+         BOOST_ASSERT_MSG(reqs[i]->get_expected_responses() <= f.get_supported_response_size(), "Request and response have incompatible sizes.");
+         infos.push_back(std::make_shared<req_info>(*reqs[i], f, get_executor()));
+      }
+
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(exec_batch_op<this_type>{this, std::make_shared<batch_info>(get_executor(), results), std::move(infos)}, token, writer_timer_);
+   }
+
    template <class Response, class CompletionToken>
    [[deprecated("Set the response with set_receive_response and use the other overload.")]]
    auto async_receive(Response& response, CompletionToken token)
    {
       set_receive_response(response);
-      return receive_channel_.async_receive(std::move(token));
+      return async_receive(std::move(token));
    }
 
    template <class CompletionToken>
    auto async_receive(CompletionToken token)
-      { return receive_channel_.async_receive(std::move(token)); }
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(receive_op<this_type>{this}, token, writer_timer_);
+   }
 
    std::size_t receive(system::error_code& ec)
    {
@@ -481,6 +758,15 @@ public:
       if (ec)
          return 0;
 
+      if (backlog_.is_enabled()) {
+         if (backlog_.empty()) {
+            ec = error::sync_receive_push_failed;
+            return 0;
+         }
+
+         return deliver_push(ec);
+      }
+
       if (!res)
          ec = error::sync_receive_push_failed;
 
@@ -503,12 +789,34 @@ public:
       receive_adapter_ = adapter::detail::make_adapter_wrapper(g);
    }
 
+   void set_setup_hook(std::function<void(request&)> f)
+      { runner_.set_setup_hook(std::move(f)); }
+
    usage get_usage() const noexcept
-      { return usage_; }
+   {
+      auto ret = usage_;
+      ret.requests_queued = queued_requests_;
+      ret.bytes_queued = queued_bytes_;
+      ret.requests_suspended = suspended_requests_;
+      ret.pipeline_depth_limit = limiter_.is_enabled() ? limiter_.get_limit() : 0;
+      return ret;
+   }
 
    auto run_is_canceled() const noexcept
       { return cancel_run_called_; }
 
+   auto has_completed_hello() const noexcept
+      { return runner_.has_completed_hello(); }
+
+   auto is_ready() const noexcept
+      { return is_open() && has_completed_hello(); }
+
+   auto const& get_latency() const noexcept
+      { return latency_; }
+
+   auto get_outstanding_requests() const noexcept
+      { return std::size(reqs_); }
+
 private:
    using receive_channel_type = asio::experimental::channel<executor_type, void(system::error_code, std::size_t)>;
    using runner_type = runner<executor_type>;
@@ -526,6 +834,10 @@ private:
       {
          BOOST_ASSERT(ptr != nullptr);
 
+         // Nobody waits for the responses of abandoned requests.
+         if (ptr->is_abandoned())
+            return false;
+
          if (ptr->is_waiting()) {
             return !ptr->req_->get_config().cancel_on_connection_lost;
          } else {
@@ -537,16 +849,25 @@ private:
 
       auto const ret = std::distance(point, std::end(reqs_));
 
-      std::for_each(point, std::end(reqs_), [](auto const& ptr) {
+      std::for_each(point, std::end(reqs_), [this](auto const& ptr) {
+         release(*ptr);
          ptr->stop();
       });
 
       reqs_.erase(point, std::end(reqs_));
+      notify_queue_space();
 
       std::for_each(std::begin(reqs_), std::end(reqs_), [](auto const& ptr) {
          return ptr->mark_waiting();
       });
 
+      // Requests that had been written are waiting again, restores
+      // the schedule order.
+      std::stable_sort(std::begin(reqs_), std::end(reqs_), [](auto const& a, auto const& b) {
+         return a->schedule_key() < b->schedule_key();
+      });
+
+      bytes_in_flight_ = 0;
       return ret;
    }
 
@@ -562,11 +883,13 @@ private:
 
       auto const ret = std::distance(point, std::end(reqs_));
 
-      std::for_each(point, std::end(reqs_), [](auto const& ptr) {
+      std::for_each(point, std::end(reqs_), [this](auto const& ptr) {
+         release(*ptr);
          ptr->stop();
       });
 
       reqs_.erase(point, std::end(reqs_));
+      notify_queue_space();
       return ret;
    }
 
@@ -576,6 +899,10 @@ private:
          case operation::exec:
          {
             cancel_unwritten_requests();
+
+            // Suspended calls are cancelled as well.
+            ++exec_cancellations_;
+            queue_timer_.cancel();
          } break;
          case operation::run:
          {
@@ -617,6 +944,19 @@ private:
       });
    }
 
+   // State shared by the requests of a batch, see async_exec_batch.
+   struct batch_info {
+      batch_info(executor_type ex, span<system::error_code> results)
+      : notifier_{ex, 1}
+      , results_{results}
+      { }
+
+      exec_notifier_type notifier_;
+      span<system::error_code> results_;
+      std::size_t pending_ = 0;
+      std::size_t read_size_ = 0;
+   };
+
    struct req_info {
    public:
       using node_type = resp3::basic_node<std::string_view>;
@@ -624,14 +964,41 @@ private:
 
       explicit req_info(request const& req, adapter_type adapter, executor_type ex)
       : notifier_{ex, 1}
-      , req_{&req}
-      , adapter_{}
-      , expected_responses_{req.get_expected_responses()}
-      , status_{status::waiting}
-      , ec_{{}}
-      , read_size_{0}
       {
-         adapter_ = [this, adapter](node_type const& nd, system::error_code& ec)
+         reset(req, std::move(adapter));
+      }
+
+      // Prepares the object for a new exec, see make_request_info.
+      void reset(request const& req, adapter_type adapter)
+      {
+         req_ = &req;
+         expected_responses_ = req.get_expected_responses();
+         status_ = status::waiting;
+         ec_ = {};
+         read_size_ = 0;
+         staged_at_ = {};
+         round_ = 0;
+         deadline_ = {};
+         deadline_slot_ = 0;
+         has_deadline_ = false;
+         expired_ = false;
+         internal_ = false;
+         owned_.reset();
+         abandoned_ = false;
+         on_response_ = nullptr;
+         batch_ = nullptr;
+         batch_index_ = 0;
+         fused_ = 0;
+         followers_.clear();
+         leader_ = nullptr;
+
+         auto const timeout = req.get_config().timeout;
+         if (timeout != clock_type::duration::zero()) {
+            deadline_ = clock_type::now() + timeout;
+            has_deadline_ = true;
+         }
+
+         adapter_ = [this, adapter = std::move(adapter)](node_type const& nd, system::error_code& ec)
          {
             auto const i = req_->get_expected_responses() - expected_responses_;
             adapter(i, nd, ec);
@@ -640,14 +1007,71 @@ private:
 
       auto proceed()
       {
+         for (auto const& f : followers_) {
+            if (!f->ec_)
+               f->ec_ = ec_;
+            f->leader_ = nullptr;
+            f->proceed();
+         }
+         followers_.clear();
+
+         if (batch_ != nullptr)
+            return on_batch_done(ec_);
+
          notifier_.try_send(std::error_code{}, 0);
       }
 
       void stop()
       {
+         for (auto const& f : followers_) {
+            f->leader_ = nullptr;
+            f->stop();
+         }
+         followers_.clear();
+
+         if (batch_ != nullptr)
+            return on_batch_done(asio::error::operation_aborted);
+
          notifier_.close();
       }
 
+      // Passes the node to the adapter of this request and of the
+      // requests that follow it, see config::single_flight. Errors of
+      // the followers only affect themselves.
+      void on_node(node_type const& nd, system::error_code& ec)
+      {
+         for (auto const& f : followers_) {
+            if (!f->ec_)
+               f->adapter_(nd, f->ec_);
+         }
+
+         adapter_(nd, ec);
+      }
+
+      // Accounts for a response that has been read.
+      void on_response_read(std::size_t read_size)
+      {
+         read_size_ += read_size;
+         --expected_responses_;
+
+         // See async_exec_progressive.
+         if (on_response_)
+            on_response_();
+
+         for (auto const& f : followers_)
+            f->on_response_read(read_size);
+      }
+
+      // Reports the result to the batch, once.
+      void on_batch_done(system::error_code ec)
+      {
+         auto* batch = std::exchange(batch_, nullptr);
+         batch->results_[batch_index_] = ec;
+         batch->read_size_ += read_size_;
+         if (--batch->pending_ == 0)
+            batch->notifier_.try_send(std::error_code{}, 0);
+      }
+
       [[nodiscard]] auto is_waiting() const noexcept
          { return status_ == status::waiting; }
 
@@ -664,11 +1088,29 @@ private:
          { status_ = status::staged; }
 
       void mark_waiting() noexcept
-         { status_ = status::waiting; }
+      {
+         status_ = status::waiting;
+         fused_ = 0;
+      }
 
       [[nodiscard]] auto stop_requested() const noexcept
          { return !notifier_.is_open();}
 
+      // Detaches the request from the exec call i.e. from the user's
+      // request and response objects. The request is copied since
+      // it must outlive the call and responses are discarded.
+      void abandon()
+      {
+         owned_ = std::make_unique<request>(*req_);
+         req_ = owned_.get();
+         adapter_ = [](node_type const&, system::error_code&) {};
+         on_response_ = nullptr;
+         abandoned_ = true;
+      }
+
+      [[nodiscard]] auto is_abandoned() const noexcept
+         { return abandoned_; }
+
       template <class CompletionToken>
       auto async_wait(CompletionToken token)
       {
@@ -683,20 +1125,246 @@ private:
       };
 
       exec_notifier_type notifier_;
-      request const* req_;
+      request const* req_ = nullptr;
       wrapped_adapter_type adapter_;
 
       // Contains the number of commands that haven't been read yet.
-      std::size_t expected_responses_;
-      status status_;
+      std::size_t expected_responses_ = 0;
+      status status_ = status::waiting;
 
       system::error_code ec_;
-      std::size_t read_size_;
+      std::size_t read_size_ = 0;
+
+      // Time at which the request was staged for writing, used to
+      // measure its latency.
+      clock_type::time_point staged_at_{};
+
+      // Virtual time used to order the request among others of the
+      // same priority, see insert_waiting.
+      std::uint64_t round_ = 0;
+
+      // See request::config::timeout.
+      clock_type::time_point deadline_{};
+      std::size_t deadline_slot_ = 0;
+      bool has_deadline_ = false;
+      bool expired_ = false;
+
+      // HELLO and health-checks, which don't count towards the queue
+      // limits, see config::max_queued_requests.
+      bool internal_ = false;
+
+      // See abandon.
+      std::unique_ptr<request> owned_;
+      bool abandoned_ = false;
+
+      // Called after each response has been read, see
+      // async_exec_progressive.
+      std::function<void()> on_response_;
+
+      // Set while the request is part of a batch, see async_exec_batch.
+      batch_info* batch_ = nullptr;
+      std::size_t batch_index_ = 0;
+
+      // Number of requests fused into a single command, this one and
+      // the ones that follow it in the queue, see stage.
+      std::size_t fused_ = 0;
+
+      // Identical requests that receive a copy of the responses to
+      // this one instead of being written, and the request this one
+      // follows, see config::single_flight.
+      std::vector<std::shared_ptr<req_info>> followers_;
+      req_info* leader_ = nullptr;
+
+      [[nodiscard]] auto get_priority() const noexcept
+         { return req_->get_config().priority; }
+
+      [[nodiscard]] auto schedule_key() const noexcept
+         { return std::make_pair(get_priority(), round_); }
    };
 
+   void add_batch(std::vector<std::shared_ptr<req_info>> const& infos, batch_info& batch)
+   {
+      for (std::size_t i = 0; i < std::size(infos); ++i) {
+         auto const& info = infos[i];
+         if (info->req_->get_config().cancel_if_not_connected && !is_open()) {
+            batch.results_[i] = error::not_connected;
+            continue;
+         }
+
+         info->batch_ = &batch;
+         info->batch_index_ = i;
+         ++batch.pending_;
+         add_request_info(info);
+      }
+   }
+
+   void cancel_batch(std::vector<std::shared_ptr<req_info>> const& infos)
+   {
+      for (auto const& info : infos) {
+         if (info->batch_ == nullptr)
+            continue;
+
+         info->batch_ = nullptr;
+         if (info->is_waiting()) {
+            remove_request(info);
+         } else {
+            abandon_request(*info);
+         }
+      }
+
+      notify_queue_space();
+   }
+
+   void abandon_request(req_info& info)
+   {
+      // The copy made by abandon has another payload.
+      forget_flight(info);
+      info.abandon();
+      ++usage_.requests_abandoned;
+   }
+
    void remove_request(std::shared_ptr<req_info> const& info)
    {
-      reqs_.erase(std::remove(std::begin(reqs_), std::end(reqs_), info));
+      if (info->leader_ != nullptr) {
+         auto& fs = info->leader_->followers_;
+         fs.erase(std::remove(std::begin(fs), std::end(fs), info), std::end(fs));
+         info->leader_ = nullptr;
+         return;
+      }
+
+      auto const iter = std::find(std::begin(reqs_), std::end(reqs_), info);
+      BOOST_ASSERT(iter != std::end(reqs_));
+      release(*info);
+      if (std::empty(info->followers_)) {
+         reqs_.erase(iter);
+      } else {
+         // The first follower takes the place of the request.
+         *iter = promote_follower(*info);
+      }
+
+      notify_queue_space();
+   }
+
+   // Attaches the request to an identical read-only request in the
+   // queue, returns false if there is none, see config::single_flight.
+   [[nodiscard]] bool try_follow(std::shared_ptr<req_info> const& info)
+   {
+      auto const& req = *info->req_;
+      if (!runner_.get_config().single_flight || !req.is_read_only() || runner_.is_internal_request(req))
+         return false;
+
+      auto const [iter, inserted] = flights_.try_emplace(req.payload(), info.get());
+      if (inserted || !can_follow(*iter->second, *info))
+         return false;
+
+      info->leader_ = iter->second;
+      iter->second->followers_.push_back(info);
+      ++usage_.requests_deduplicated;
+      return true;
+   }
+
+   // A request can follow another one if no response to the latter
+   // has been read yet and their cancellation settings agree.
+   [[nodiscard]] bool can_follow(req_info const& leader, req_info const& ri) const noexcept
+   {
+      if (leader.expected_responses_ != leader.req_->get_expected_responses())
+         return false;
+
+      // The response to the requests at the front might be half read,
+      // fused requests are read together.
+      if (!on_push_ && parser_.get_consumed() != 0) {
+         auto const n = (std::max)(reqs_.front()->fused_, std::size_t{1});
+         for (std::size_t i = 0; i < n && i < std::size(reqs_); ++i) {
+            if (reqs_[i].get() == &leader)
+               return false;
+         }
+      }
+
+      auto const& a = leader.req_->get_config();
+      auto const& b = ri.req_->get_config();
+      if (a.cancel_on_connection_lost != b.cancel_on_connection_lost || a.cancel_if_unresponded != b.cancel_if_unresponded)
+         return false;
+
+      // The follower shares the timeout of the leader, which must not
+      // be longer than its own.
+      return !ri.has_deadline_ || !leader.is_waiting() || (leader.has_deadline_ && leader.deadline_ <= ri.deadline_);
+   }
+
+   auto promote_follower(req_info& ri) -> std::shared_ptr<req_info>
+   {
+      auto next = ri.followers_.front();
+      next->followers_.assign(std::next(std::begin(ri.followers_)), std::end(ri.followers_));
+      ri.followers_.clear();
+      next->leader_ = nullptr;
+      for (auto const& f : next->followers_)
+         f->leader_ = next.get();
+
+      next->round_ = ri.round_;
+      ++queued_requests_;
+      queued_bytes_ += std::size(next->req_->payload());
+      flights_[next->req_->payload()] = next.get();
+      if (next->has_deadline_) {
+         next->deadline_slot_ = deadlines_.add(next->deadline_, next.get());
+         arm_deadline_timer();
+      }
+
+      return next;
+   }
+
+   void forget_flight(req_info& ri)
+   {
+      auto const iter = flights_.find(ri.req_->payload());
+      if (iter != std::end(flights_) && iter->second == &ri)
+         flights_.erase(iter);
+   }
+
+   auto get_queue_full_action() const noexcept
+      { return runner_.get_config().on_queue_full; }
+
+   // Returns true if this number of requests and bytes does not fit
+   // in the queue, see config::max_queued_requests. Anything fits in
+   // an empty queue.
+   [[nodiscard]] bool is_queue_full(std::size_t requests, std::size_t bytes) const noexcept
+   {
+      auto const& cfg = runner_.get_config();
+      if (queued_requests_ == 0)
+         return false;
+
+      if (cfg.max_queued_requests != 0 && queued_requests_ + requests > cfg.max_queued_requests)
+         return true;
+
+      return cfg.max_queued_bytes != 0 && queued_bytes_ + bytes > cfg.max_queued_bytes;
+   }
+
+   [[nodiscard]] bool is_queue_full(request const& req) const noexcept
+   {
+      return !runner_.is_internal_request(req) && is_queue_full(1, std::size(req.payload()));
+   }
+
+   // New requests don't overtake suspended ones.
+   [[nodiscard]] bool must_wait_for_queue(std::size_t requests, std::size_t bytes) const noexcept
+   {
+      return suspended_requests_ != 0 || is_queue_full(requests, bytes);
+   }
+
+   [[nodiscard]] bool must_wait_for_queue(request const& req) const noexcept
+   {
+      return !runner_.is_internal_request(req) && must_wait_for_queue(1, std::size(req.payload()));
+   }
+
+   // Called by a suspended exec when it stops waiting, admitted or
+   // cancelled. The others are woken up to check again: those that
+   // waited only because of it would otherwise wait forever.
+   void leave_queue_wait()
+   {
+      --suspended_requests_;
+      notify_queue_space();
+   }
+
+   void notify_queue_space()
+   {
+      if (suspended_requests_ != 0)
+         queue_timer_.cancel();
    }
 
    using reqs_type = std::deque<std::shared_ptr<req_info>>;
@@ -705,6 +1373,9 @@ private:
    template <class, class> friend struct writer_op;
    template <class, class> friend struct run_op;
    template <class> friend struct exec_op;
+   template <class> friend struct receive_op;
+   template <class> friend struct exec_batch_op;
+   template <class> friend struct deadline_op;
    template <class, class, class> friend struct run_all_op;
 
    void cancel_push_requests()
@@ -713,11 +1384,14 @@ private:
             return !(ptr->is_staged() && ptr->req_->get_expected_responses() == 0);
       });
 
-      std::for_each(point, std::end(reqs_), [](auto const& ptr) {
+      std::for_each(point, std::end(reqs_), [this](auto const& ptr) {
+         bytes_in_flight_ -= std::size(ptr->req_->payload());
+         release(*ptr);
          ptr->proceed();
       });
 
       reqs_.erase(point, std::end(reqs_));
+      notify_queue_space();
    }
 
    [[nodiscard]] bool is_writing() const noexcept
@@ -725,22 +1399,175 @@ private:
       return !write_buffer_.empty();
    }
 
+   // Returns the info of a new exec. Infos of completed execs are
+   // reused, which saves the allocation of the info and the
+   // construction of its notifier on every call.
+   auto make_request_info(request const& req, adapter_type adapter) -> std::shared_ptr<req_info>
+   {
+      if (std::empty(free_infos_))
+         return std::make_shared<req_info>(req, std::move(adapter), get_executor());
+
+      auto info = std::move(free_infos_.back());
+      free_infos_.pop_back();
+      info->reset(req, std::move(adapter));
+      return info;
+   }
+
+   // Called by an exec when it completes. The info is only reused if
+   // nothing else refers to it e.g. the queue or a leader, see
+   // config::single_flight.
+   void recycle(std::shared_ptr<req_info> info)
+   {
+      if (info.use_count() != 1 || info->stop_requested() || std::size(free_infos_) >= max_free_infos)
+         return;
+
+      // Releases what the adapters captured e.g. the response of
+      // async_exec_progressive.
+      info->adapter_ = nullptr;
+      info->on_response_ = nullptr;
+      info->owned_.reset();
+      free_infos_.push_back(std::move(info));
+   }
+
    void add_request_info(std::shared_ptr<req_info> const& info)
    {
-      reqs_.push_back(info);
+      if (try_follow(info))
+         return;
+
+      info->internal_ = runner_.is_internal_request(*info->req_);
+      if (!info->internal_) {
+         ++queued_requests_;
+         queued_bytes_ += std::size(info->req_->payload());
+      }
 
       if (info->req_->has_hello_priority()) {
+         reqs_.push_back(info);
          auto rend = std::partition_point(std::rbegin(reqs_), std::rend(reqs_), [](auto const& e) {
                return e->is_waiting();
          });
 
          std::rotate(std::rbegin(reqs_), std::rbegin(reqs_) + 1, rend);
+      } else {
+         insert_waiting(info);
+      }
+
+      if (info->has_deadline_) {
+         info->deadline_slot_ = deadlines_.add(info->deadline_, info.get());
+         arm_deadline_timer();
       }
 
       if (is_open() && !is_writing())
          writer_timer_.cancel();
    }
 
+   // Must be called for every request that leaves the queue.
+   void release(req_info& ri)
+   {
+      if (!ri.internal_) {
+         --queued_requests_;
+         queued_bytes_ -= std::size(ri.req_->payload());
+      }
+
+      clear_deadline(ri);
+      forget_flight(ri);
+   }
+
+   void clear_deadline(req_info& ri)
+   {
+      if (!ri.has_deadline_)
+         return;
+
+      deadlines_.remove(ri.deadline_slot_, &ri);
+      ri.has_deadline_ = false;
+      if (deadlines_.size() == 0)
+         stop_deadline_timer();
+   }
+
+   void arm_deadline_timer()
+   {
+      auto const tp = deadlines_.next_expiry();
+      if (deadline_op_stopped_ != nullptr && tp >= deadline_timer_.expiry())
+         return;
+
+      stop_deadline_timer();
+      deadline_op_stopped_ = std::make_shared<bool>(false);
+      deadline_timer_.expires_at(tp);
+      auto token = [](system::error_code) {};
+      asio::async_compose
+         < decltype(token)
+         , void(system::error_code)
+         >(deadline_op<this_type>{this, deadline_op_stopped_}, token, deadline_timer_);
+   }
+
+   void stop_deadline_timer()
+   {
+      if (deadline_op_stopped_ == nullptr)
+         return;
+
+      *deadline_op_stopped_ = true;
+      deadline_op_stopped_ = nullptr;
+      deadline_timer_.cancel();
+   }
+
+   void shed_expired_requests()
+   {
+      bool any = false;
+      deadlines_.expire(clock_type::now(), [&any](req_info* ri) {
+         ri->has_deadline_ = false;
+         ri->expired_ = true;
+         any = true;
+      });
+
+      if (!any)
+         return;
+
+      // Only waiting requests have deadlines, see coalesce_requests.
+      auto point = std::stable_partition(std::begin(reqs_), std::end(reqs_), [](auto const& ptr) {
+         return !ptr->expired_;
+      });
+
+      std::for_each(point, std::end(reqs_), [this](auto const& ptr) {
+         release(*ptr);
+         ptr->ec_ = error::request_timeout;
+         ptr->proceed();
+         ++usage_.requests_shed;
+      });
+
+      reqs_.erase(point, std::end(reqs_));
+      notify_queue_space();
+   }
+
+   // Inserts the request in the waiting segment of the queue, which
+   // is kept sorted by priority and round. The round of a request is
+   // one past the round of the previous request of the same producer
+   // (start-time fair queuing) so that producers are served in
+   // round-robin. With a single producer and priority requests are
+   // appended at the end, as in plain FIFO.
+   void insert_waiting(std::shared_ptr<req_info> const& info)
+   {
+      auto const point = std::partition_point(std::begin(reqs_), std::end(reqs_), [](auto const& ri) {
+            return !ri->is_waiting();
+      });
+
+      auto const c = static_cast<std::size_t>(info->get_priority());
+      if (point == std::end(reqs_)) {
+         // Nothing is waiting, rounds can be forgotten.
+         for (auto& e : producer_rounds_)
+            e.clear();
+      }
+
+      auto& last = producer_rounds_.at(c)[info->req_->get_config().producer];
+      info->round_ = (std::max)(virtual_time_.at(c), last + 1);
+      last = info->round_;
+
+      auto const key = info->schedule_key();
+      auto const pos = std::upper_bound(point, std::end(reqs_), key, [](auto const& k, auto const& ri) {
+            return k < ri->schedule_key();
+      });
+
+      reqs_.insert(pos, info);
+   }
+
    template <class CompletionToken, class Logger>
    auto reader(Logger l, CompletionToken&& token)
    {
@@ -770,6 +1597,54 @@ private:
          >(run_op<this_type, Logger>{this, l}, token, writer_timer_);
    }
 
+   // Returns true if the request can't be staged now because it
+   // would exceed the replay window, see
+   // config::replay_max_bytes_in_flight.
+   [[nodiscard]] bool exceeds_replay_window(std::size_t size) const noexcept
+   {
+      auto const window = runner_.get_config().replay_max_bytes_in_flight;
+      if (!is_replaying_ || window == 0)
+         return false;
+
+      // Let at least one request through, regardless of its size.
+      return bytes_in_flight_ != 0 && bytes_in_flight_ + size > window;
+   }
+
+   // Returns true and arms the writer timer if the next write should
+   // wait for more requests.
+   [[nodiscard]] bool start_write_hold()
+   {
+      auto const interval = runner_.get_config().write_coalesce_interval;
+      if (interval == std::chrono::steady_clock::duration::zero() || is_replaying_)
+         return false;
+
+      // Nothing to write or no response pending: holding the write
+      // would only add latency.
+      if (std::empty(reqs_) || !reqs_.back()->is_waiting() || reqs_.front()->is_waiting())
+         return false;
+
+      if (!is_holding_write())
+         return false;
+
+      writer_timer_.expires_after(interval);
+      return true;
+   }
+
+   // Returns false if enough requests have been gathered.
+   [[nodiscard]] bool is_holding_write() const noexcept
+   {
+      auto const& cfg = runner_.get_config();
+      std::size_t requests = 0;
+      std::size_t bytes = 0;
+      for (auto iter = std::crbegin(reqs_); iter != std::crend(reqs_) && (*iter)->is_waiting(); ++iter) {
+         bytes += std::size((*iter)->req_->payload());
+         if (++requests >= cfg.write_coalesce_max_requests || bytes >= cfg.write_coalesce_max_bytes)
+            return false;
+      }
+
+      return requests != 0;
+   }
+
    [[nodiscard]] bool coalesce_requests()
    {
       // Coalesces the requests and marks them staged. After a
@@ -778,16 +1653,112 @@ private:
             return !ri->is_waiting();
       });
 
-      std::for_each(point, std::cend(reqs_), [this](auto const& ri) {
+      auto const now = clock_type::now();
+      auto const limit = limiter_.get_limit();
+      auto const batch_max = runner_.get_config().batch_max_bytes_per_write;
+      std::size_t batch_bytes = 0;
+      auto in_flight = static_cast<std::size_t>(std::distance(std::cbegin(reqs_), point));
+      auto iter = point;
+      for (; iter != std::cend(reqs_); ++iter) {
+         auto const& ri = *iter;
+         auto const size = std::size(ri->req_->payload());
+         if (exceeds_replay_window(size))
+            break;
+
+         // See config::adaptive_pipeline, lets at least one through.
+         if (in_flight != 0 && in_flight >= limit)
+            break;
+
+         // Batch requests are at the end of the queue, see
+         // insert_waiting.
+         if (ri->get_priority() == request_priority::batch) {
+            if (batch_bytes != 0 && batch_bytes + size > batch_max)
+               break;
+            batch_bytes += size;
+         }
+
+         auto& vt = virtual_time_.at(static_cast<std::size_t>(ri->get_priority()));
+         vt = (std::max)(vt, ri->round_);
+         ++in_flight;
+
          // Stage the request.
-         write_buffer_ += ri->req_->payload();
+         stage(ri);
          ri->mark_staged();
+         ri->staged_at_ = now;
+         clear_deadline(*ri);
          usage_.commands_sent += ri->expected_responses_;
-      });
+         usage_.requests_sent += 1;
+         bytes_in_flight_ += size;
+      }
+
+      flush_fused();
+
+      // The backlog has been drained, from now on requests are
+      // written as soon as they arrive.
+      if (iter == std::cend(reqs_))
+         is_replaying_ = false;
 
       usage_.bytes_sent += std::size(write_buffer_);
+      if (point != iter)
+         usage_.writes += 1;
+
+      return point != iter;
+   }
+
+   // Appends the payload of the request to the write buffer, or fuses
+   // it with the previous requests, see config::read_fusion_max_requests.
+   void stage(std::shared_ptr<req_info> const& ri)
+   {
+      auto const payload = ri->req_->payload();
+      if (fuser_.is_enabled()) {
+         if (fuser_.try_add(payload)) {
+            if (fuser_.size() == 1)
+               fusion_leader_ = ri.get();
+            return;
+         }
+
+         flush_fused();
+         if (fuser_.try_add(payload)) {
+            fusion_leader_ = ri.get();
+            return;
+         }
+      }
+
+      write_buffer_ += payload;
+   }
+
+   void flush_fused()
+   {
+      auto const n = fuser_.flush(write_buffer_);
+      if (n > 1) {
+         fusion_leader_->fused_ = n;
+         usage_.commands_sent -= n - 1;
+         usage_.requests_fused += n;
+      }
+
+      fusion_leader_ = nullptr;
+   }
 
-      return point != std::cend(reqs_);
+   // Passes the i-th element of the response to a fused command to
+   // the i-th fused request. Errors are passed to all of them.
+   void on_fused_node(resp3::basic_node<std::string_view> const& nd, system::error_code& ec)
+   {
+      auto const n = reqs_.front()->fused_;
+      if (nd.depth == 0) {
+         if (resp3::is_aggregate(nd.data_type))
+            return;
+
+         for (std::size_t i = 0; i < n && !ec; ++i)
+            reqs_[i]->on_node(nd, ec);
+
+         return;
+      }
+
+      if (nd.depth == 1 && fused_index_ < n) {
+         auto elem = nd;
+         elem.depth = 0;
+         reqs_[fused_index_++]->on_node(elem, ec);
+      }
    }
 
    bool is_waiting_response() const noexcept
@@ -855,6 +1826,21 @@ private:
       return parser_.get_suggested_buffer_growth(4096);
    }
 
+   // Adapts the oldest push in the backlog into the receive response.
+   std::size_t deliver_push(system::error_code& ec)
+   {
+      auto& e = backlog_.front();
+      for (auto const& nd : e.nodes) {
+         receive_adapter_(resp3::basic_node<std::string_view>{nd.data_type, nd.aggregate_size, nd.depth, nd.value}, ec);
+         if (ec)
+            break;
+      }
+
+      auto const size = e.size;
+      backlog_.pop_front();
+      return size;
+   }
+
    enum class parse_result { needs_more, push, resp };
 
    using parse_ret_type = std::pair<parse_result, std::size_t>;
@@ -891,6 +1877,18 @@ private:
       if (!on_push_) // Prepare for new message.
          on_push_ = is_next_push();
 
+      if (on_push_ && backlog_.is_enabled()) {
+         auto adapter = [this](resp3::basic_node<std::string_view> const& nd, system::error_code&)
+            { push_nodes_.push_back({nd.data_type, nd.aggregate_size, nd.depth, std::string{nd.value}}); };
+
+         if (!resp3::parse(parser_, data, adapter, ec))
+            return std::make_pair(parse_result::needs_more, 0);
+
+         usage_.pushes_dropped += backlog_.add(std::move(push_nodes_), parser_.get_consumed());
+         push_nodes_ = {};
+         return on_finish_parsing(parse_result::push);
+      }
+
       if (on_push_) {
          if (!resp3::parse(parser_, data, receive_adapter_, ec))
             return std::make_pair(parse_result::needs_more, 0);
@@ -906,7 +1904,13 @@ private:
       BOOST_ASSERT(reqs_.front() != nullptr);
       BOOST_ASSERT(reqs_.front()->expected_responses_ != 0);
 
-      if (!resp3::parse(parser_, data, reqs_.front()->adapter_, ec))
+      if (reqs_.front()->fused_ > 1)
+         return on_read_fused(data, ec);
+
+      auto adapter = [ri = reqs_.front().get()](resp3::basic_node<std::string_view> const& nd, system::error_code& e)
+         { ri->on_node(nd, e); };
+
+      if (!resp3::parse(parser_, data, adapter, ec))
          return std::make_pair(parse_result::needs_more, 0);
 
       if (ec) {
@@ -915,15 +1919,58 @@ private:
          return std::make_pair(parse_result::resp, 0);
       }
 
-      reqs_.front()->read_size_ += parser_.get_consumed();
+      on_response_read(parser_.get_consumed());
+      return on_finish_parsing(parse_result::resp);
+   }
+
+   parse_ret_type on_read_fused(std::string_view data, system::error_code& ec)
+   {
+      auto adapter = [this](resp3::basic_node<std::string_view> const& nd, system::error_code& e)
+         { on_fused_node(nd, e); };
 
-      if (--reqs_.front()->expected_responses_ == 0) {
+      if (!resp3::parse(parser_, data, adapter, ec))
+         return std::make_pair(parse_result::needs_more, 0);
+
+      auto const n = reqs_.front()->fused_;
+      fused_index_ = 0;
+      if (ec) {
+         for (std::size_t i = 0; i < n; ++i) {
+            reqs_[i]->ec_ = ec;
+            reqs_[i]->proceed();
+         }
+
+         return std::make_pair(parse_result::resp, 0);
+      }
+
+      // The bytes read are split evenly among the fused requests.
+      auto const size = parser_.get_consumed() / n;
+      for (std::size_t i = 0; i < n; ++i)
+         on_response_read(size);
+
+      return on_finish_parsing(parse_result::resp);
+   }
+
+   // Accounts for a response to the first request in the queue and
+   // completes the request once all its responses have been read.
+   void on_response_read(std::size_t read_size)
+   {
+      reqs_.front()->on_response_read(read_size);
+      if (reqs_.front()->expected_responses_ == 0) {
          // Done with this request.
+         bytes_in_flight_ -= std::size(reqs_.front()->req_->payload());
+         release(*reqs_.front());
+         auto const latency = clock_type::now() - reqs_.front()->staged_at_;
+         latency_.add(latency);
+         limiter_.on_response(latency);
          reqs_.front()->proceed();
          reqs_.pop_front();
-      }
+         notify_queue_space();
 
-      return on_finish_parsing(parse_result::resp);
+         // Requests might be held back by the replay window or the
+         // pipeline depth limit, see coalesce_requests.
+         if ((is_replaying_ || limiter_.is_enabled()) && !is_writing())
+            writer_timer_.cancel();
+      }
    }
 
    void reset()
@@ -933,19 +1980,43 @@ private:
       parser_.reset();
       on_push_ = false;
       cancel_run_called_ = false;
+      bytes_in_flight_ = 0;
+      limiter_.set_config(runner_.get_config());
+      limiter_.reset();
+      fuser_.set_config(runner_.get_config());
+      fused_index_ = 0;
+      backlog_.set_config(runner_.get_config());
+      push_nodes_.clear();
+
+      // Requests that are already in the queue when the connection
+      // is established are written in a paced manner.
+      is_replaying_ = !reqs_.empty();
    }
 
-   asio::ssl::context ctx_;
+   std::shared_ptr<asio::ssl::context> ctx_;
    std::unique_ptr<next_layer_type> stream_;
 
    // Notice we use a timer to simulate a condition-variable. It is
    // also more suitable than a channel and the notify operation does
    // not suspend.
    timer_type writer_timer_;
+
+   // Notifies async_exec calls suspended because the queue is full.
+   timer_type queue_timer_;
+
+   // Single timer serving the timeouts of all requests, see
+   // request::config::timeout.
+   timer_type deadline_timer_;
+   timer_wheel<req_info> deadlines_;
+   std::shared_ptr<bool> deadline_op_stopped_;
    receive_channel_type receive_channel_;
    runner_type runner_;
    receiver_adapter_type receive_adapter_;
 
+   // Pushes waiting for async_receive, see config::push_backlog.
+   push_backlog backlog_;
+   push_backlog::nodes_type push_nodes_;
+
    using dyn_buffer_type = asio::dynamic_string_buffer<char, std::char_traits<char>, std::allocator<char>>;
 
    std::string read_buffer_;
@@ -953,10 +2024,40 @@ private:
    std::string write_buffer_;
    reqs_type reqs_;
    resp3::parser parser_{};
+
+   // Infos of completed execs, see make_request_info.
+   static constexpr std::size_t max_free_infos = 64;
+   std::vector<std::shared_ptr<req_info>> free_infos_;
    bool on_push_ = false;
    bool cancel_run_called_ = false;
+   bool is_replaying_ = false;
+
+   // Number of bytes written (or staged) but not yet responded.
+   std::size_t bytes_in_flight_ = 0;
+
+   // Number and sum of the payload sizes of the requests in reqs_,
+   // except internal ones.
+   std::size_t queued_requests_ = 0;
+   std::size_t queued_bytes_ = 0;
 
+   // Scheduling state per priority, see insert_waiting.
+   std::array<std::unordered_map<std::size_t, std::uint64_t>, 2> producer_rounds_;
+   std::array<std::uint64_t, 2> virtual_time_{};
+   std::size_t suspended_requests_ = 0;
+   std::size_t exec_cancellations_ = 0;
+
+   latency_tracker latency_;
+   concurrency_limiter limiter_;
    usage usage_;
+
+   // See config::read_fusion_max_requests.
+   read_fuser fuser_;
+   req_info* fusion_leader_ = nullptr;
+   std::size_t fused_index_ = 0;
+
+   // Read-only requests in the queue by payload, see
+   // config::single_flight.
+   std::unordered_map<std::string_view, req_info*> flights_;
 };
 
 } // boost::redis::detail
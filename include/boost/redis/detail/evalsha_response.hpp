@@ -0,0 +1,102 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_EVALSHA_RESPONSE_HPP
+#define BOOST_REDIS_EVALSHA_RESPONSE_HPP
+
+#include <boost/redis/adapter/detail/response_traits.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <limits>
+#include <string_view>
+
+namespace boost::redis::detail
+{
+
+/* Response type of async_evalsha. Passes the response to the adapter
+ * of the user's response, except a NOSCRIPT error, which is recorded
+ * so that the script can be loaded and the call retried. The first
+ * skip responses are ignored e.g. the one to SCRIPT LOAD, unless it
+ * is an error: it is then passed in place of the response to the
+ * script, which can only be NOSCRIPT.
+ */
+template <class Adapter>
+struct evalsha_response {
+   Adapter adapter;
+   std::size_t skip = 0;
+   bool intercept = true;
+   bool noscript = false;
+   bool load_failed = false;
+};
+
+template <class Adapter>
+class evalsha_adapter {
+public:
+   explicit evalsha_adapter(evalsha_response<Adapter>& resp) noexcept
+   : resp_{&resp}
+   { }
+
+   void operator()(std::size_t i, resp3::basic_node<std::string_view> const& nd, system::error_code& ec)
+   {
+      if (i < resp_->skip) {
+         // e.g. a script that doesn't compile.
+         if (nd.depth == 0 && is_error(nd.data_type)) {
+            resp_->load_failed = true;
+            resp_->adapter(0, nd, ec);
+         }
+         return;
+      }
+
+      if (resp_->load_failed)
+         return;
+
+      if (resp_->intercept && is_noscript(nd)) {
+         resp_->noscript = true;
+         return;
+      }
+
+      resp_->adapter(i - resp_->skip, nd, ec);
+   }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return (std::numeric_limits<std::size_t>::max)();}
+
+private:
+   static bool is_error(resp3::type t) noexcept
+   {
+      return t == resp3::type::simple_error || t == resp3::type::blob_error;
+   }
+
+   static bool is_noscript(resp3::basic_node<std::string_view> const& nd) noexcept
+   {
+      return nd.depth == 0
+         && nd.data_type == resp3::type::simple_error
+         && nd.value.substr(0, 8) == "NOSCRIPT";
+   }
+
+   evalsha_response<Adapter>* resp_;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <class Adapter>
+struct response_traits<redis::detail::evalsha_response<Adapter>> {
+   using response_type = redis::detail::evalsha_response<Adapter>;
+   using adapter_type = redis::detail::evalsha_adapter<Adapter>;
+
+   static auto adapt(response_type& resp) noexcept
+      { return adapter_type{resp}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_EVALSHA_RESPONSE_HPP
@@ -202,6 +202,9 @@ public:
          >(check_health_op<health_checker, Connection, Logger>{this, &conn, l}, token, conn);
    }
 
+   bool is_own_request(request const& req) const noexcept
+      { return &req == &req_; }
+
    std::size_t cancel(operation op)
    {
       switch (op) {
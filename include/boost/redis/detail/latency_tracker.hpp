@@ -0,0 +1,112 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_LATENCY_TRACKER_HPP
+#define BOOST_REDIS_LATENCY_TRACKER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace boost::redis::detail
+{
+
+/* Keeps track of request latencies i.e. the time between writing a
+ * request and reading its last response.
+ *
+ * Provides a smoothed average (same weights as the TCP RTT
+ * estimator) and a histogram with power-of-two buckets in
+ * microseconds from which percentiles can be estimated. The
+ * histogram is halved every `window` samples so that percentiles
+ * follow recent latencies rather than the whole history.
+ */
+class latency_tracker {
+public:
+   using duration = std::chrono::steady_clock::duration;
+
+   static constexpr std::size_t buckets = 32;
+   static constexpr std::uint64_t window = 1024;
+
+   void add(duration d) noexcept
+   {
+      if (d < duration::zero())
+         d = duration::zero();
+
+      if (samples_ == 0)
+         average_ = d;
+      else
+         average_ += (d - average_) / 8;
+
+      ++histogram_[to_bucket(d)];
+      ++samples_;
+
+      if (++weight_ == window) {
+         weight_ = 0;
+         for (auto& e : histogram_) {
+            e /= 2;
+            weight_ += e;
+         }
+      }
+   }
+
+   // Returns the smoothed average latency or zero if there are no
+   // samples.
+   [[nodiscard]] auto get_average() const noexcept
+      { return average_; }
+
+   [[nodiscard]] auto get_samples() const noexcept
+      { return samples_; }
+
+   // Returns an upper bound of the p-th percentile, p in [0, 1], or
+   // zero if there are no samples.
+   [[nodiscard]] auto get_percentile(double p) const noexcept -> duration
+   {
+      if (weight_ == 0)
+         return duration::zero();
+
+      auto const target = static_cast<std::uint64_t>(p * static_cast<double>(weight_ - 1)) + 1;
+      std::uint64_t acc = 0;
+      std::size_t i = 0;
+      for (; i < buckets - 1; ++i) {
+         acc += histogram_[i];
+         if (acc >= target)
+            break;
+      }
+
+      return std::chrono::microseconds{std::uint64_t{1} << i};
+   }
+
+   void reset() noexcept
+   {
+      histogram_ = {};
+      average_ = duration::zero();
+      samples_ = 0;
+      weight_ = 0;
+   }
+
+private:
+   // Bucket i holds latencies in [2^(i-1), 2^i) microseconds.
+   static auto to_bucket(duration d) noexcept -> std::size_t
+   {
+      auto us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+      std::size_t i = 0;
+      for (; us != 0 && i < buckets - 1; us >>= 1)
+         ++i;
+
+      return i;
+   }
+
+   std::array<std::uint64_t, buckets> histogram_{};
+   duration average_{};
+   std::uint64_t samples_ = 0;
+
+   // Sum of the histogram.
+   std::uint64_t weight_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_LATENCY_TRACKER_HPP
@@ -0,0 +1,140 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_PUSH_BACKLOG_HPP
+#define BOOST_REDIS_PUSH_BACKLOG_HPP
+
+#include <boost/redis/config.hpp>
+#include <boost/redis/resp3/node.hpp>
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+/* Bounded queue of pushes waiting for async_receive, see
+ * config::push_backlog.
+ *
+ * Pushes are stored as owning nodes so that the reader can consume
+ * them from the read buffer immediately, they are replayed into the
+ * receive response when delivered. In conflate mode the entries of
+ * pubsub messages are indexed by kind, pattern and channel, a new
+ * message replaces the pending one with the same key in place.
+ */
+class push_backlog {
+public:
+   using nodes_type = std::vector<resp3::node>;
+
+   struct entry {
+      nodes_type nodes;
+      std::size_t size = 0;
+      std::string key;
+   };
+
+   void set_config(config const& cfg)
+   {
+      policy_ = cfg.push_backlog;
+      max_ = (std::max)(cfg.max_push_backlog, std::size_t{1});
+   }
+
+   [[nodiscard]] bool is_enabled() const noexcept
+      { return policy_ != push_backlog_policy::block; }
+
+   [[nodiscard]] bool empty() const noexcept
+      { return std::empty(entries_); }
+
+   [[nodiscard]] auto size() const noexcept
+      { return std::size(entries_); }
+
+   // Returns the number of pushes dropped or replaced by this one.
+   std::size_t add(nodes_type nodes, std::size_t size)
+   {
+      auto key = policy_ == push_backlog_policy::conflate ? conflation_key(nodes) : std::string{};
+
+      if (!std::empty(key)) {
+         if (auto const iter = index_.find(key); iter != std::end(index_)) {
+            iter->second->nodes = std::move(nodes);
+            iter->second->size = size;
+            return 1;
+         }
+      }
+
+      std::size_t dropped = 0;
+      if (std::size(entries_) == max_) {
+         if (policy_ == push_backlog_policy::drop_newest)
+            return 1;
+
+         pop_front();
+         dropped = 1;
+      }
+
+      entries_.push_back({std::move(nodes), size, std::move(key)});
+      if (!std::empty(entries_.back().key))
+         index_.emplace(entries_.back().key, std::prev(std::end(entries_)));
+
+      return dropped;
+   }
+
+   // Precondition: !empty().
+   entry& front() noexcept
+      { return entries_.front(); }
+
+   void pop_front()
+   {
+      if (!std::empty(entries_.front().key))
+         index_.erase(entries_.front().key);
+
+      entries_.pop_front();
+   }
+
+private:
+   // The conflation key of message, smessage and pmessage pushes,
+   // empty for any other push. It is made of the kind, the pattern
+   // and the channel so that a pmessage doesn't replace a message of
+   // the same channel, nor a pmessage of another pattern. The pattern
+   // is prefixed with its size since pattern and channel are binary
+   // safe.
+   static std::string conflation_key(nodes_type const& nodes)
+   {
+      if (std::size(nodes) < 4 || nodes.front().data_type != resp3::type::push)
+         return {};
+
+      auto const& kind = nodes[1].value;
+      std::string_view pattern;
+      std::string_view channel;
+      if ((kind == "message" || kind == "smessage") && std::size(nodes) == 4) {
+         channel = nodes[2].value;
+      } else if (kind == "pmessage" && std::size(nodes) == 5) {
+         pattern = nodes[2].value;
+         channel = nodes[3].value;
+      } else {
+         return {};
+      }
+
+      auto key = kind;
+      key += ' ';
+      key += std::to_string(std::size(pattern));
+      key += ' ';
+      key.append(pattern);
+      key.append(channel);
+      return key;
+   }
+
+   push_backlog_policy policy_ = push_backlog_policy::block;
+   std::size_t max_ = 1;
+   std::list<entry> entries_;
+   std::unordered_map<std::string_view, std::list<entry>::iterator> index_;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_PUSH_BACKLOG_HPP
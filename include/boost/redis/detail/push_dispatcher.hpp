@@ -0,0 +1,130 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_PUSH_DISPATCHER_HPP
+#define BOOST_REDIS_PUSH_DISPATCHER_HPP
+
+#include <boost/redis/adapter/detail/response_traits.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace boost::redis::detail
+{
+
+/* Receive response that decodes pubsub messages as they are parsed
+ * and passes them to the handler of their channel or pattern, without
+ * storing the nodes.
+ *
+ * Nodes of a push might be parsed in different reads, after which
+ * earlier views into the read buffer are invalid. The channel and
+ * pattern are therefore copied (into buffers that are reused) while
+ * the message, which is the last element, is passed as a view.
+ */
+class push_dispatcher {
+public:
+   using handler_type = std::function<void(std::string_view channel, std::string_view message)>;
+
+   std::unordered_map<std::string, handler_type> channels;
+   std::unordered_map<std::string, handler_type> patterns;
+
+   void on_node(resp3::basic_node<std::string_view> const& nd)
+   {
+      if (nd.depth == 0) {
+         index_ = 0;
+         kind_ = kind::other;
+         return;
+      }
+
+      if (nd.depth != 1)
+         return;
+
+      switch (index_++) {
+         case 0:
+         {
+            if (nd.value == "message" || nd.value == "smessage")
+               kind_ = kind::message;
+            else if (nd.value == "pmessage")
+               kind_ = kind::pmessage;
+         } break;
+         case 1:
+         {
+            if (kind_ == kind::message)
+               channel_.assign(nd.value);
+            else if (kind_ == kind::pmessage)
+               pattern_.assign(nd.value);
+         } break;
+         case 2:
+         {
+            if (kind_ == kind::message)
+               dispatch(channels, channel_, nd.value);
+            else if (kind_ == kind::pmessage)
+               channel_.assign(nd.value);
+         } break;
+         case 3:
+         {
+            if (kind_ == kind::pmessage)
+               dispatch(patterns, pattern_, nd.value);
+         } break;
+         default:;
+      }
+   }
+
+private:
+   enum class kind { other, message, pmessage };
+
+   void dispatch(std::unordered_map<std::string, handler_type> const& table, std::string const& key, std::string_view msg)
+   {
+      auto const iter = table.find(key);
+      if (iter != std::cend(table))
+         iter->second(channel_, msg);
+   }
+
+   kind kind_ = kind::other;
+   std::size_t index_ = 0;
+   std::string channel_;
+   std::string pattern_;
+};
+
+class push_dispatcher_adapter {
+public:
+   explicit push_dispatcher_adapter(push_dispatcher& d) noexcept
+   : dispatcher_{&d}
+   { }
+
+   void operator()(std::size_t, resp3::basic_node<std::string_view> const& nd, system::error_code&)
+      { dispatcher_->on_node(nd); }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return (std::numeric_limits<std::size_t>::max)();}
+
+private:
+   push_dispatcher* dispatcher_;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <>
+struct response_traits<redis::detail::push_dispatcher> {
+   using response_type = redis::detail::push_dispatcher;
+   using adapter_type = redis::detail::push_dispatcher_adapter;
+
+   static auto adapt(response_type& d) noexcept
+      { return adapter_type{d}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_PUSH_DISPATCHER_HPP
@@ -0,0 +1,174 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_READ_FUSER_HPP
+#define BOOST_REDIS_READ_FUSER_HPP
+
+#include <boost/redis/config.hpp>
+#include <boost/redis/resp3/parser.hpp>
+#include <boost/redis/resp3/serialization.hpp>
+#include <boost/redis/resp3/type.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+/* Fuses consecutive requests that consist of a single GET into one
+ * MGET, and of a single HGET on the same key into one HMGET. The i-th
+ * element of the response belongs to the i-th fused request, see
+ * config::read_fusion_max_requests.
+ *
+ * Payloads are stored as views, they must not change until flush is
+ * called.
+ */
+class read_fuser {
+public:
+   void set_config(config const& cfg) noexcept
+      { max_ = cfg.read_fusion_max_requests; }
+
+   [[nodiscard]] bool is_enabled() const noexcept
+      { return max_ > 1; }
+
+   // Returns the number of requests in the group.
+   [[nodiscard]] auto size() const noexcept
+      { return std::size(args_); }
+
+   // Adds the payload to the group. Returns false if the payload is
+   // not a fusible read, or can't be fused with the group, or the group
+   // is full.
+   [[nodiscard]] bool try_add(std::string_view payload)
+   {
+      if (std::size(args_) >= max_)
+         return false;
+
+      kind k = kind::none;
+      std::string_view key;
+      std::string_view field;
+      if (!parse(payload, k, key, field))
+         return false;
+
+      if (!std::empty(args_) && (k != kind_ || (k == kind::hget && key != key_)))
+         return false;
+
+      if (std::empty(args_)) {
+         kind_ = k;
+         key_ = key;
+         first_ = payload;
+      }
+
+      args_.push_back(k == kind::hget ? field : key);
+      return true;
+   }
+
+   // Appends the group to the payload and clears it. Returns the number
+   // of requests that have been fused.
+   std::size_t flush(std::string& payload)
+   {
+      auto const n = std::size(args_);
+      if (n == 1) {
+         // Nothing to fuse with.
+         payload += first_;
+      } else if (n > 1) {
+         if (kind_ == kind::get) {
+            resp3::add_header(payload, resp3::type::array, 1 + n);
+            resp3::add_bulk(payload, std::string_view{"MGET"});
+         } else {
+            resp3::add_header(payload, resp3::type::array, 2 + n);
+            resp3::add_bulk(payload, std::string_view{"HMGET"});
+            resp3::add_bulk(payload, key_);
+         }
+
+         for (auto const& arg : args_)
+            resp3::add_bulk(payload, arg);
+      }
+
+      args_.clear();
+      kind_ = kind::none;
+      return n;
+   }
+
+private:
+   enum class kind { none, get, hget };
+
+   // Parses a payload that contains exactly one GET or HGET.
+   static bool parse(std::string_view payload, kind& k, std::string_view& key, std::string_view& field)
+   {
+      std::size_t n = 0;
+      if (!read_header(payload, '*', n))
+         return false;
+
+      std::string_view cmd;
+      if (!read_blob(payload, cmd))
+         return false;
+
+      if (n == 2 && iequals(cmd, "GET")) {
+         k = kind::get;
+         return read_blob(payload, key) && std::empty(payload);
+      }
+
+      if (n == 3 && iequals(cmd, "HGET")) {
+         k = kind::hget;
+         return read_blob(payload, key) && read_blob(payload, field) && std::empty(payload);
+      }
+
+      return false;
+   }
+
+   static bool read_header(std::string_view& s, char c, std::size_t& n)
+   {
+      if (std::empty(s) || s.front() != c)
+         return false;
+
+      auto const end = s.find(resp3::parser::sep);
+      if (end == std::string_view::npos)
+         return false;
+
+      auto const res = std::from_chars(s.data() + 1, s.data() + end, n);
+      if (res.ec != std::errc{} || res.ptr != s.data() + end)
+         return false;
+
+      s.remove_prefix(end + std::size(resp3::parser::sep));
+      return true;
+   }
+
+   static bool read_blob(std::string_view& s, std::string_view& blob)
+   {
+      std::size_t n = 0;
+      if (!read_header(s, '$', n) || std::size(s) < n + std::size(resp3::parser::sep))
+         return false;
+
+      blob = s.substr(0, n);
+      if (s.substr(n, std::size(resp3::parser::sep)) != resp3::parser::sep)
+         return false;
+
+      s.remove_prefix(n + std::size(resp3::parser::sep));
+      return true;
+   }
+
+   static bool iequals(std::string_view a, std::string_view b) noexcept
+   {
+      return std::size(a) == std::size(b) &&
+         std::equal(std::cbegin(a), std::cend(a), std::cbegin(b), [](char x, char y) {
+            return std::toupper(static_cast<unsigned char>(x)) == y;
+         });
+   }
+
+   std::size_t max_ = 0;
+   kind kind_ = kind::none;
+   std::string_view key_;
+   std::string_view first_;
+   std::vector<std::string_view> args_;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_READ_FUSER_HPP
@@ -26,6 +26,7 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <functional>
 
 namespace boost::redis::detail
 {
@@ -57,6 +58,7 @@ struct hello_op {
             return;
          }
 
+         runner_->hello_completed_ = true;
          self.complete({});
       }
    }
@@ -87,6 +89,8 @@ public:
    {
       BOOST_ASIO_CORO_REENTER (coro_)
       {
+         runner_->hello_completed_ = false;
+
          BOOST_ASIO_CORO_YIELD
          asio::experimental::make_parallel_group(
             [this](auto token) { return runner_->async_run_all(*conn_, logger_, token); },
@@ -200,6 +204,17 @@ public:
 
    config const& get_config() const noexcept {return cfg_;}
 
+   void set_setup_hook(std::function<void(request&)> f)
+      { setup_hook_ = std::move(f); }
+
+   // True if the HELLO handshake of the last run completed successfully.
+   bool has_completed_hello() const noexcept {return hello_completed_;}
+
+   // True if the request is issued by the runner itself i.e. HELLO
+   // and health-checks.
+   bool is_internal_request(request const& req) const noexcept
+      { return &req == &hello_req_ || health_checker_.is_own_request(req); }
+
 private:
    using resolver_type = resolver<Executor>;
    using connector_type = connector<Executor>;
@@ -235,6 +250,8 @@ private:
       if (hello_resp_.has_value())
          hello_resp_.value().clear();
       push_hello(cfg_, hello_req_);
+      if (setup_hook_)
+         setup_hook_(hello_req_);
    }
 
    bool has_error_in_response() const noexcept
@@ -261,6 +278,8 @@ private:
    request hello_req_;
    generic_response hello_resp_;
    config cfg_;
+   std::function<void(request&)> setup_hook_;
+   bool hello_completed_ = false;
 };
 
 } // boost::redis::detail
@@ -0,0 +1,95 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SCAN_PAGE_HPP
+#define BOOST_REDIS_SCAN_PAGE_HPP
+
+#include <boost/redis/error.hpp>
+#include <boost/redis/adapter/detail/response_traits.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+/* The response to a SCAN-like command i.e. the next cursor and a page
+ * of elements.
+ *
+ * The strings in elements are reused from one page to the next to
+ * avoid allocations, only the first size of them belong to the
+ * current page.
+ */
+struct scan_page {
+   std::string cursor;
+   std::vector<std::string> elements;
+   std::size_t size = 0;
+
+   void clear() noexcept
+   {
+      cursor.clear();
+      size = 0;
+   }
+};
+
+class scan_page_adapter {
+public:
+   explicit scan_page_adapter(scan_page& page) noexcept
+   : page_{&page}
+   { }
+
+   void operator()(std::size_t, resp3::basic_node<std::string_view> const& nd, system::error_code& ec)
+   {
+      switch (nd.data_type) {
+         case resp3::type::simple_error: ec = redis::error::resp3_simple_error; return;
+         case resp3::type::blob_error: ec = redis::error::resp3_blob_error; return;
+         default:;
+      }
+
+      // The response is a pair where the first element is the cursor
+      // and the second is the array of elements.
+      if (nd.depth == 1 && !resp3::is_aggregate(nd.data_type)) {
+         page_->cursor.assign(nd.value);
+      } else if (nd.depth == 2) {
+         auto& elems = page_->elements;
+         if (page_->size < std::size(elems))
+            elems[page_->size].assign(nd.value);
+         else
+            elems.emplace_back(nd.value);
+
+         ++page_->size;
+      }
+   }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return std::size_t{1};}
+
+private:
+   scan_page* page_;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <>
+struct response_traits<redis::detail::scan_page> {
+   using response_type = redis::detail::scan_page;
+   using adapter_type = redis::detail::scan_page_adapter;
+
+   static auto adapt(response_type& page) noexcept
+      { return adapter_type{page}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_SCAN_PAGE_HPP
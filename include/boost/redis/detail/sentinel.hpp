@@ -0,0 +1,434 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SENTINEL_HPP
+#define BOOST_REDIS_SENTINEL_HPP
+
+#include <boost/redis/detail/connection_base.hpp>
+#include <boost/redis/detail/helper.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/error.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/experimental/parallel_group.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+// Queries all sentinels in parallel for the master address and
+// completes when the first one answers, all of them failed or the
+// resolve timeout expires.
+template <class Sentinel, class Logger>
+struct sentinel_resolve_op {
+   Sentinel* sentinel_ = nullptr;
+   config const* cfg_ = nullptr;
+   Logger logger_;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {})
+   {
+      BOOST_ASIO_CORO_REENTER (coro_)
+      {
+         sentinel_->start_queries(*cfg_, logger_);
+         sentinel_->timer_.expires_after(cfg_->sentinel.resolve_timeout);
+
+         // The timer is used as a condition variable that is notified
+         // by the completion of each query, see start_queries.
+         while (sentinel_->is_querying()) {
+            BOOST_ASIO_CORO_YIELD
+            sentinel_->timer_.async_wait(std::move(self));
+            if (!ec || is_cancelled(self)) {
+               logger_.trace("sentinel-resolve-op: timeout/canceled.");
+               break;
+            }
+         }
+
+         // Waits for all queries to finish so that the connections can
+         // be reused in the next resolve.
+         sentinel_->cancel_queries();
+         sentinel_->timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+         while (sentinel_->pending_ops_ != 0) {
+            BOOST_ASIO_CORO_YIELD
+            sentinel_->timer_.async_wait(std::move(self));
+         }
+
+         if (is_cancelled(self)) {
+            self.complete(asio::error::operation_aborted);
+            return;
+         }
+
+         if (!sentinel_->answered_) {
+            logger_.on_sentinel_resolve(error::sentinel_resolve_failed, {});
+            self.complete(error::sentinel_resolve_failed);
+            return;
+         }
+
+         logger_.on_sentinel_resolve({}, sentinel_->master_);
+         self.complete({});
+      }
+   }
+};
+
+// Completes when a +switch-master event for our master is received.
+template <class Sentinel>
+struct sentinel_failover_op {
+   Sentinel* sentinel_ = nullptr;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro_) for (;;)
+      {
+         BOOST_ASIO_CORO_YIELD
+         sentinel_->watcher_.async_receive(std::move(self));
+         BOOST_REDIS_CHECK_OP0(;)
+
+         if (sentinel_->consume_pushes()) {
+            sentinel_->watcher_.cancel(operation::run);
+            self.complete({});
+            return;
+         }
+      }
+   }
+};
+
+// Keeps a subscription to +switch-master on one of the sentinels
+// and completes once a failover is announced, after closing the
+// connection so that it reconnects to the new master immediately.
+template <class Sentinel, class Connection, class Logger>
+struct sentinel_watch_op {
+   Sentinel* sentinel_ = nullptr;
+   Connection* conn_ = nullptr;
+   config const* cfg_ = nullptr;
+   Logger logger_;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()( Self& self
+                  , std::array<std::size_t, 2> order = {}
+                  , system::error_code ec0 = {}
+                  , system::error_code ec1 = {})
+   {
+      BOOST_ASIO_CORO_REENTER (coro_) for (;;)
+      {
+         sentinel_->prepare_watcher(*cfg_);
+
+         BOOST_ASIO_CORO_YIELD
+         asio::experimental::make_parallel_group(
+            [s = sentinel_, l = logger_](auto token) { return s->watcher_.async_run(s->watcher_cfg_, l, token); },
+            [s = sentinel_](auto token) { return s->async_wait_failover(token); }
+         ).async_wait(
+            asio::experimental::wait_for_one(),
+            std::move(self));
+
+         if (is_cancelled(self)) {
+            logger_.trace("sentinel-watch-op: canceled. Exiting ...");
+            self.complete(asio::error::operation_aborted);
+            return;
+         }
+
+         if (order[0] == 1 && !ec1) {
+            logger_.on_sentinel_resolve({}, sentinel_->failover_.value());
+            conn_->cancel(operation::run);
+            self.complete({});
+            return;
+         }
+
+         // The connection with the sentinel has been lost, waits a
+         // bit and tries the next one.
+         logger_.trace("sentinel-watch-op: connection with sentinel lost.");
+         ignore_unused(ec0);
+         sentinel_->watch_timer_.expires_after(cfg_->reconnect_wait_interval);
+         BOOST_ASIO_CORO_YIELD
+         sentinel_->watch_timer_.async_wait(std::move(self));
+         if (is_cancelled(self)) {
+            self.complete(asio::error::operation_aborted);
+            return;
+         }
+
+         sentinel_->next_watch_index(*cfg_);
+      }
+   }
+};
+
+// Configuration used to connect to the sentinel at index i.
+inline auto make_sentinel_config(config const& cfg, std::size_t i)
+{
+   auto ret = cfg;
+   ret.addr = cfg.sentinel.addresses.at(i);
+   ret.sentinel.addresses.clear();
+   ret.username = cfg.sentinel.username;
+   ret.password = cfg.sentinel.password;
+   ret.database_index = std::nullopt;
+   ret.use_ssl = false;
+   ret.health_check_interval = std::chrono::seconds::zero();
+   ret.setup.clear();
+   return ret;
+}
+
+// Returns the new address of the master announced by the last
+// +switch-master message in nodes, if any. Its payload has the format
+//
+//    <master name> <old ip> <old port> <new ip> <new port>
+inline auto
+find_switch_master(
+   std::vector<resp3::node> const& nodes,
+   std::string_view master_name) -> std::optional<address>
+{
+   std::optional<address> ret;
+   for (std::size_t i = 0; i + 3 < std::size(nodes); ++i) {
+      if (nodes[i].depth != 0 || nodes[i].aggregate_size != 3)
+         continue;
+
+      if (nodes[i + 1].value != "message" || nodes[i + 2].value != "+switch-master")
+         continue;
+
+      std::array<std::string_view, 5> fields;
+      std::string_view payload = nodes[i + 3].value;
+      std::size_t k = 0;
+      for (; k < std::size(fields) && !payload.empty(); ++k) {
+         auto const pos = payload.find(' ');
+         fields[k] = payload.substr(0, pos);
+         payload = pos == std::string_view::npos ? std::string_view{} : payload.substr(pos + 1);
+      }
+
+      if (k == std::size(fields) && fields[0] == master_name)
+         ret = address{std::string{fields[3]}, std::string{fields[4]}};
+   }
+
+   return ret;
+}
+
+/* Resolves the master address with sentinels and watches for
+ * failovers.
+ *
+ * Sentinels are reached with plain (non-ssl) connections without
+ * health-checks. One connection per sentinel is used to query the
+ * master address and an additional one is kept subscribed to
+ * +switch-master.
+ */
+template <class Executor>
+class sentinel {
+public:
+   using timer_type =
+      asio::basic_waitable_timer<
+         std::chrono::steady_clock,
+         asio::wait_traits<std::chrono::steady_clock>,
+         Executor>;
+
+   explicit sentinel(Executor ex)
+   : ex_{ex}
+   , watcher_{ex, asio::ssl::context{asio::ssl::context::tlsv12_client}, (std::numeric_limits<std::size_t>::max)()}
+   , timer_{ex}
+   , watch_timer_{ex}
+   {
+      watcher_.set_receive_response(watcher_resp_);
+   }
+
+   template <class Logger, class CompletionToken>
+   auto async_resolve_master(config const& cfg, Logger l, CompletionToken token)
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(sentinel_resolve_op<sentinel, Logger>{this, &cfg, l}, token, timer_);
+   }
+
+   template <class Connection, class Logger, class CompletionToken>
+   auto async_watch(Connection& conn, config const& cfg, Logger l, CompletionToken token)
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(sentinel_watch_op<sentinel, Connection, Logger>{this, &conn, &cfg, l}, token, watch_timer_);
+   }
+
+   void cancel()
+   {
+      cancel_queries();
+      watcher_.cancel(operation::all);
+      timer_.cancel();
+      watch_timer_.cancel();
+   }
+
+   // The address of the master resolved by the last call to
+   // async_resolve_master.
+   auto const& get_master_address() const noexcept
+      { return master_; }
+
+   // Sets addr to the address announced in a failover if there is
+   // one. Returns true in this case.
+   bool take_failover(address& addr)
+   {
+      if (!failover_)
+         return false;
+
+      addr = *failover_;
+      master_ = *failover_;
+      failover_.reset();
+      return true;
+   }
+
+   [[nodiscard]] bool has_failover() const noexcept
+      { return failover_.has_value(); }
+
+private:
+   using connection_type = connection_base<Executor>;
+   using response_type = response<std::optional<std::array<std::string, 2>>>;
+
+   template <class, class> friend struct sentinel_resolve_op;
+   template <class> friend struct sentinel_failover_op;
+   template <class, class, class> friend struct sentinel_watch_op;
+
+   template <class CompletionToken>
+   auto async_wait_failover(CompletionToken token)
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(sentinel_failover_op<sentinel>{this}, token, watch_timer_);
+   }
+
+   [[nodiscard]] bool is_querying() const noexcept
+      { return !answered_ && pending_execs_ != 0; }
+
+   template <class Logger>
+   void start_queries(config const& cfg, Logger l)
+   {
+      answered_.reset();
+      failover_.reset();
+
+      req_ = request{};
+      req_.get_config().cancel_if_not_connected = false;
+      req_.get_config().cancel_on_connection_lost = true;
+      req_.get_config().cancel_if_unresponded = true;
+      req_.push("SENTINEL", "get-master-addr-by-name", cfg.sentinel.master_name);
+
+      auto const n = std::size(cfg.sentinel.addresses);
+      while (std::size(conns_) < n) {
+         conns_.push_back(
+            std::make_unique<connection_type>(
+               ex_,
+               asio::ssl::context{asio::ssl::context::tlsv12_client},
+               (std::numeric_limits<std::size_t>::max)()));
+      }
+
+      resps_.resize(n);
+      cfgs_.resize(n);
+
+      for (std::size_t i = 0; i < n; ++i) {
+         cfgs_[i] = make_sentinel_config(cfg, i);
+         resps_[i] = response_type{};
+         conns_[i]->reset_stream();
+         pending_ops_ += 2;
+         ++pending_execs_;
+
+         conns_[i]->async_exec(req_, resps_[i], [this, i](system::error_code ec, std::size_t)
+         {
+            --pending_execs_;
+            --pending_ops_;
+
+            auto const& res = std::get<0>(resps_[i]);
+            if (!ec && res.has_value() && res.value().has_value() && !answered_) {
+               answered_ = i;
+               master_ = address{res.value().value().at(0), res.value().value().at(1)};
+            }
+
+            conns_[i]->cancel(operation::all);
+            timer_.cancel();
+         });
+
+         conns_[i]->async_run(cfgs_[i], l, [this, i](system::error_code)
+         {
+            --pending_ops_;
+            conns_[i]->cancel(operation::exec);
+            timer_.cancel();
+         });
+      }
+   }
+
+   void cancel_queries()
+   {
+      for (auto& conn : conns_)
+         conn->cancel(operation::all);
+   }
+
+   void prepare_watcher(config const& cfg)
+   {
+      if (!answered_)
+         answered_ = 0;
+
+      watcher_cfg_ = make_sentinel_config(cfg, *answered_);
+      watcher_cfg_.setup.push("SUBSCRIBE", "+switch-master");
+      master_name_ = cfg.sentinel.master_name;
+      if (watcher_resp_.has_value())
+         watcher_resp_.value().clear();
+      watcher_.reset_stream();
+   }
+
+   void next_watch_index(config const& cfg)
+   {
+      answered_ = (answered_.value_or(0) + 1) % std::size(cfg.sentinel.addresses);
+   }
+
+   // Looks for a +switch-master message in the pushes received by
+   // the watcher.
+   bool consume_pushes()
+   {
+      if (!watcher_resp_.has_value()) {
+         watcher_resp_ = generic_response{};
+         return false;
+      }
+
+      if (auto addr = find_switch_master(watcher_resp_.value(), master_name_))
+         failover_ = std::move(addr);
+
+      watcher_resp_.value().clear();
+      return failover_.has_value();
+   }
+
+   Executor ex_;
+
+   // Connections used to query the master address, one per sentinel.
+   std::vector<std::unique_ptr<connection_type>> conns_;
+   std::vector<response_type> resps_;
+   std::vector<config> cfgs_;
+   request req_;
+
+   // Connection subscribed to +switch-master.
+   connection_type watcher_;
+   config watcher_cfg_;
+   generic_response watcher_resp_;
+   std::string master_name_;
+
+   timer_type timer_;
+   timer_type watch_timer_;
+   std::size_t pending_ops_ = 0;
+   std::size_t pending_execs_ = 0;
+   std::optional<std::size_t> answered_;
+   address master_;
+   std::optional<address> failover_;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_SENTINEL_HPP
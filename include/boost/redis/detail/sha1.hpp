@@ -0,0 +1,22 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SHA1_HPP
+#define BOOST_REDIS_SHA1_HPP
+
+#include <string>
+#include <string_view>
+
+namespace boost::redis::detail
+{
+
+// Returns the SHA1 digest of data as 40 lowercase hex digits, the
+// format used by Redis to identify scripts.
+auto sha1_hex(std::string_view data) -> std::string;
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_SHA1_HPP
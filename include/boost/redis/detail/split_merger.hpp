@@ -0,0 +1,144 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SPLIT_MERGER_HPP
+#define BOOST_REDIS_SPLIT_MERGER_HPP
+
+#include <boost/redis/request.hpp>
+#include <boost/redis/adapter/detail/response_traits.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace boost::redis::detail
+{
+
+/* Merges the responses to the parts of a split command into a single
+ * response that is passed to the adapter of the user's response, as
+ * if the command had not been split:
+ *
+ *    - split_sum: integer responses are added e.g. SADD.
+ *    - split_last: the last integer response is kept e.g. RPUSH.
+ *    - split_concat: the elements of the arrays are concatenated into
+ *      an array of total elements e.g. MGET.
+ *    - split_ok: a single OK e.g. MSET.
+ *
+ * An error response is passed through and ends the merge.
+ */
+template <class Adapter>
+class split_merger {
+public:
+   using node_type = resp3::basic_node<std::string_view>;
+
+   split_merger(Adapter adapter, command_flags policy, std::size_t total)
+   : adapter_{std::move(adapter)}
+   , policy_{policy}
+   , total_{total}
+   { }
+
+   void on_node(node_type const& nd, system::error_code& ec)
+   {
+      if (nd.depth == 0 && (nd.data_type == resp3::type::simple_error || nd.data_type == resp3::type::blob_error)) {
+         failed_ = true;
+         adapter_(0, nd, ec);
+         return;
+      }
+
+      if (is(command_flags::split_concat)) {
+         if (nd.depth != 0) {
+            adapter_(0, nd, ec);
+         } else if (!header_sent_) {
+            auto header = nd;
+            header.aggregate_size = total_;
+            header_sent_ = true;
+            adapter_(0, header, ec);
+         }
+      } else if (nd.depth == 0 && nd.data_type == resp3::type::number) {
+         std::int64_t n = 0;
+         std::from_chars(nd.value.data(), nd.value.data() + std::size(nd.value), n);
+         if (is(command_flags::split_sum))
+            sum_ += n;
+         else
+            sum_ = n;
+      }
+   }
+
+   // Passes the merged response to the adapter.
+   void finish(system::error_code& ec)
+   {
+      if (is(command_flags::split_concat)) {
+         if (!header_sent_)
+            adapter_(0, node_type{resp3::type::array, 0, 0, {}}, ec);
+      } else if (is(command_flags::split_ok)) {
+         adapter_(0, node_type{resp3::type::simple_string, 1, 0, "OK"}, ec);
+      } else {
+         value_ = std::to_string(sum_);
+         adapter_(0, node_type{resp3::type::number, 1, 0, value_}, ec);
+      }
+   }
+
+   [[nodiscard]] bool has_failed() const noexcept
+      { return failed_; }
+
+private:
+   bool is(command_flags f) const noexcept
+      { return (policy_ & f) != command_flags::none; }
+
+   Adapter adapter_;
+   command_flags policy_;
+   std::size_t total_;
+   std::int64_t sum_ = 0;
+   std::string value_;
+   bool header_sent_ = false;
+   bool failed_ = false;
+};
+
+// Response type of the parts of a split command.
+template <class Merger>
+struct split_part {
+   Merger* merger = nullptr;
+};
+
+template <class Merger>
+class split_part_adapter {
+public:
+   explicit split_part_adapter(split_part<Merger>& part) noexcept
+   : merger_{part.merger}
+   { }
+
+   void operator()(std::size_t, resp3::basic_node<std::string_view> const& nd, system::error_code& ec)
+      { merger_->on_node(nd, ec); }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return std::size_t{1};}
+
+private:
+   Merger* merger_;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <class Merger>
+struct response_traits<redis::detail::split_part<Merger>> {
+   using response_type = redis::detail::split_part<Merger>;
+   using adapter_type = redis::detail::split_part_adapter<Merger>;
+
+   static auto adapt(response_type& part) noexcept
+      { return adapter_type{part}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_SPLIT_MERGER_HPP
@@ -0,0 +1,96 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SPSC_QUEUE_HPP
+#define BOOST_REDIS_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+/* Bounded lock-free queue for one producer thread and one consumer
+ * thread.
+ *
+ * The capacity is rounded up to a power of two. Head and tail are
+ * only ever incremented, each by one side, and live on different
+ * cache lines so that the producer and the consumer don't invalidate
+ * each other's cached indices on every operation.
+ */
+template <class T>
+class spsc_queue {
+public:
+   explicit spsc_queue(std::size_t capacity)
+   : slots_(round_up(capacity))
+   , mask_{std::size(slots_) - 1}
+   { }
+
+   // Producer side, returns false if the queue is full.
+   bool try_push(T v)
+   {
+      auto const tail = tail_.load(std::memory_order_relaxed);
+      if (tail - head_cache_ == std::size(slots_)) {
+         head_cache_ = head_.load(std::memory_order_acquire);
+         if (tail - head_cache_ == std::size(slots_))
+            return false;
+      }
+
+      slots_[tail & mask_] = std::move(v);
+      tail_.store(tail + 1, std::memory_order_release);
+      return true;
+   }
+
+   // Consumer side, returns false if the queue is empty.
+   bool try_pop(T& v)
+   {
+      auto const head = head_.load(std::memory_order_relaxed);
+      if (head == tail_cache_) {
+         tail_cache_ = tail_.load(std::memory_order_acquire);
+         if (head == tail_cache_)
+            return false;
+      }
+
+      // Moved out so that the slot doesn't keep the value alive.
+      v = std::move(slots_[head & mask_]);
+      slots_[head & mask_] = T{};
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+   }
+
+   // Approximate when called concurrently with push or pop.
+   [[nodiscard]] auto size() const noexcept -> std::size_t
+      { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+   [[nodiscard]] auto capacity() const noexcept
+      { return std::size(slots_); }
+
+private:
+   static auto round_up(std::size_t n) noexcept -> std::size_t
+   {
+      std::size_t r = 1;
+      while (r < n)
+         r <<= 1;
+      return r;
+   }
+
+   std::vector<T> slots_;
+   std::size_t mask_;
+
+   // Written by the consumer.
+   alignas(64) std::atomic<std::size_t> head_{0};
+   std::size_t tail_cache_ = 0;
+
+   // Written by the producer.
+   alignas(64) std::atomic<std::size_t> tail_{0};
+   std::size_t head_cache_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_SPSC_QUEUE_HPP
@@ -0,0 +1,131 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_TIMER_WHEEL_HPP
+#define BOOST_REDIS_TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+/* A hashed timing wheel.
+ *
+ * Deadlines are hashed into slots by tick, entries whose deadline is
+ * more than one revolution ahead share the slot with closer ones and
+ * are skipped until their time comes. Allows a single timer to
+ * serve any number of deadlines with O(1) insertion and removal.
+ */
+template <class T>
+class timer_wheel {
+public:
+   using clock_type = std::chrono::steady_clock;
+   using duration = clock_type::duration;
+   using time_point = clock_type::time_point;
+
+   explicit
+   timer_wheel(
+      duration tick = std::chrono::milliseconds{1},
+      std::size_t slots = 512)
+   : tick_{(std::max)(tick, duration{1})}
+   , slots_(std::max<std::size_t>(slots, 1))
+   { }
+
+   // Adds an entry and returns the slot where it was stored, which
+   // must be passed to remove.
+   auto add(time_point deadline, T* value) -> std::size_t
+   {
+      if (size_ == 0)
+         next_tick_ = to_tick(clock_type::now());
+
+      auto const t = (std::max)(to_tick(deadline), next_tick_);
+      auto const slot = static_cast<std::size_t>(t % std::size(slots_));
+      slots_[slot].emplace_back(deadline, value);
+      ++size_;
+      return slot;
+   }
+
+   void remove(std::size_t slot, T* value)
+   {
+      auto& s = slots_.at(slot);
+      auto const iter = std::find_if(std::begin(s), std::end(s), [value](auto const& e) {
+         return e.second == value;
+      });
+
+      if (iter != std::end(s)) {
+         *iter = s.back();
+         s.pop_back();
+         --size_;
+      }
+   }
+
+   // Removes all entries whose deadline is not after now and calls
+   // f on each of them.
+   template <class F>
+   void expire(time_point now, F f)
+   {
+      auto const last = to_tick(now);
+      if (last < next_tick_)
+         return;
+
+      // The current tick is visited again in the next call since it
+      // is not over yet.
+      auto const n = std::size(slots_);
+      auto const count = (std::min)(static_cast<std::size_t>((std::min)(last - next_tick_, std::uint64_t{n})) + 1, n);
+      for (std::size_t i = 0; i < count && size_ != 0; ++i) {
+         auto& s = slots_[static_cast<std::size_t>((next_tick_ + i) % n)];
+         auto const point = std::partition(std::begin(s), std::end(s), [now](auto const& e) {
+            return now < e.first;
+         });
+
+         std::vector<std::pair<time_point, T*>> expired(point, std::end(s));
+         size_ -= std::size(expired);
+         s.erase(point, std::end(s));
+         for (auto const& e : expired)
+            f(e.second);
+      }
+
+      next_tick_ = last;
+   }
+
+   // Returns the time at which the next call to expire might find
+   // an expired entry, max() if there are no entries.
+   [[nodiscard]] auto next_expiry() const noexcept -> time_point
+   {
+      if (size_ == 0)
+         return (time_point::max)();
+
+      auto const n = std::size(slots_);
+      std::uint64_t t = next_tick_;
+      for (std::size_t i = 0; i < n; ++i, ++t) {
+         if (!slots_[static_cast<std::size_t>(t % n)].empty())
+            break;
+      }
+
+      // End of the tick.
+      return time_point{tick_ * static_cast<duration::rep>(t + 1)};
+   }
+
+   [[nodiscard]] auto size() const noexcept
+      { return size_; }
+
+private:
+   auto to_tick(time_point tp) const noexcept -> std::uint64_t
+      { return static_cast<std::uint64_t>(tp.time_since_epoch() / tick_); }
+
+   duration tick_;
+   std::vector<std::vector<std::pair<time_point, T*>>> slots_;
+   std::uint64_t next_tick_ = 0;
+   std::size_t size_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_TIMER_WHEEL_HPP
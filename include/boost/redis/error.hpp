@@ -81,6 +81,18 @@ enum class error
 
    /// Incompatible node depth.
    incompatible_node_depth,
+
+   /// None of the sentinels could resolve the master address.
+   sentinel_resolve_failed,
+
+   /// The request queue of the connection is full.
+   queue_full,
+
+   /// The request timed out before being written.
+   request_timeout,
+
+   /// The command can't be split, see `boost::redis::async_exec_split`.
+   not_splittable,
 };
 
 /** \internal
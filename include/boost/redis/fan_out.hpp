@@ -0,0 +1,144 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_FAN_OUT_HPP
+#define BOOST_REDIS_FAN_OUT_HPP
+
+#include <boost/redis/detail/spsc_queue.hpp>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace boost::redis {
+
+/** @brief An immutable pubsub message.
+ *  @ingroup high-level-api
+ *
+ *  The channel and the payload are stored in a single buffer.
+ */
+class pubsub_message {
+public:
+   /// Constructor.
+   pubsub_message(std::string_view channel, std::string_view payload)
+   : channel_size_{std::size(channel)}
+   {
+      data_.reserve(std::size(channel) + std::size(payload));
+      data_.append(channel);
+      data_.append(payload);
+   }
+
+   /// Returns the channel the message was published to.
+   [[nodiscard]] auto channel() const noexcept
+      { return std::string_view{data_}.substr(0, channel_size_); }
+
+   /// Returns the payload of the message.
+   [[nodiscard]] auto payload() const noexcept
+      { return std::string_view{data_}.substr(channel_size_); }
+
+private:
+   std::string data_;
+   std::size_t channel_size_;
+};
+
+/** @brief Distributes pubsub messages to consumers on other threads.
+ *  @ingroup high-level-api
+ *
+ *  Each message is copied once, into a reference counted
+ *  `boost::redis::pubsub_message`, and a pointer to it is pushed to
+ *  the bounded lock-free queue of every consumer. Consumers poll their
+ *  queue with `consumer::try_pop`, each from a single thread of its
+ *  choice.
+ *
+ *  Pushing never blocks: when the queue of a consumer is full the
+ *  message is dropped for that consumer only and counted in
+ *  `consumer::dropped`, so a slow consumer never stalls the
+ *  connection or the other consumers.
+ *
+ *  The fan-out object is called as a handler of
+ *  `boost::redis::basic_subscriber`, e.g.
+ *
+ *  @code
+ *  sub.subscribe("market-data", std::ref(fo));
+ *  @endcode
+ *
+ *  Consumers must be added before the first message is published.
+ */
+class fan_out {
+public:
+   /// Pointer to a message shared by all consumers.
+   using message_ptr = std::shared_ptr<pubsub_message const>;
+
+   /// The receiving end of a fan-out.
+   class consumer {
+   public:
+      /// Constructor.
+      explicit consumer(std::size_t capacity)
+      : queue_{capacity}
+      { }
+
+      /** @brief Pops the oldest message.
+       *
+       *  @returns False if there are no messages. Must not be called
+       *  concurrently from more than one thread.
+       */
+      bool try_pop(message_ptr& msg)
+         { return queue_.try_pop(msg); }
+
+      /// Returns the number of messages waiting in the queue.
+      [[nodiscard]] auto size() const noexcept
+         { return queue_.size(); }
+
+      /// Returns the number of messages dropped because the queue was full.
+      [[nodiscard]] auto dropped() const noexcept
+         { return dropped_.load(std::memory_order_relaxed); }
+
+   private:
+      friend class fan_out;
+
+      void push(message_ptr const& msg)
+      {
+         if (!queue_.try_push(msg))
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      detail::spsc_queue<message_ptr> queue_;
+      std::atomic<std::size_t> dropped_{0};
+   };
+
+   /** @brief Adds a consumer.
+    *
+    *  @param capacity Maximum number of messages waiting in its queue,
+    *  rounded up to a power of two.
+    *  @returns The consumer, which remains valid as long as this object.
+    */
+   consumer& add_consumer(std::size_t capacity = 1024)
+      { return consumers_.emplace_back(capacity); }
+
+   /// Publishes a message to all consumers.
+   void operator()(std::string_view channel, std::string_view payload)
+   {
+      if (std::empty(consumers_))
+         return;
+
+      auto const msg = std::make_shared<pubsub_message const>(channel, payload);
+      for (auto& c : consumers_)
+         c.push(msg);
+   }
+
+   /// Returns the number of consumers.
+   [[nodiscard]] auto size() const noexcept
+      { return std::size(consumers_); }
+
+private:
+   std::deque<consumer> consumers_;
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_FAN_OUT_HPP
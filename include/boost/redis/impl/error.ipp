@@ -44,6 +44,10 @@ struct error_category_impl : system::error_category {
 	 case error::ssl_handshake_timeout: return "SSL handshake timeout.";
 	 case error::sync_receive_push_failed: return "Can't receive server push synchronously without blocking.";
 	 case error::incompatible_node_depth: return "Incompatible node depth.";
+	 case error::sentinel_resolve_failed: return "None of the sentinels could resolve the master address.";
+	 case error::queue_full: return "The request queue of the connection is full.";
+	 case error::request_timeout: return "The request timed out before being written.";
+	 case error::not_splittable: return "The command can't be split.";
 	 default: BOOST_ASSERT(false); return "Boost.Redis error.";
       }
    }
@@ -44,6 +44,23 @@ void logger::on_resolve(system::error_code const& ec, asio::ip::tcp::resolver::r
    std::clog << std::endl;
 }
 
+void logger::on_sentinel_resolve(system::error_code const& ec, address const& addr)
+{
+   if (level_ < level::info)
+      return;
+
+   write_prefix();
+
+   std::clog << "sentinel: master address ";
+
+   if (ec)
+      std::clog << ec.message();
+   else
+      std::clog << addr.host << ":" << addr.port;
+
+   std::clog << std::endl;
+}
+
 void logger::on_connect(system::error_code const& ec, asio::ip::tcp::endpoint const& ep)
 {
    if (level_ < level::info)
@@ -147,6 +164,9 @@ logger::on_hello(
       std::clog << "hello-op: " << ec.message();
       if (resp.has_error())
          std::clog << " (" << resp.error().diagnostic << ")";
+   } else if (resp.has_error()) {
+      // Errors in HELLO or in the setup commands.
+      std::clog << "hello-op: " << resp.error().diagnostic;
    } else {
       std::clog << "hello-op: Success";
    }
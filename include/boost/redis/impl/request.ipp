@@ -6,6 +6,10 @@
 
 #include <boost/redis/request.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
 #include <string_view>
 
 namespace boost::redis::detail {
@@ -18,4 +22,133 @@ auto has_response(std::string_view cmd) -> bool
    return false;
 }
 
+namespace {
+
+struct command_info {
+   std::string_view name;
+   command_flags flags;
+};
+
+constexpr auto read_only = command_flags::read_only;
+constexpr auto blocking = command_flags::blocking;
+constexpr auto blocking_option = command_flags::blocking_option;
+constexpr auto split_sum = command_flags::split_sum;
+constexpr auto split_last = command_flags::split_last;
+constexpr auto split_concat = command_flags::split_concat;
+constexpr auto split_ok = command_flags::split_ok;
+constexpr auto no_leading_key = command_flags::no_leading_key;
+constexpr auto split_pairs = command_flags::split_pairs;
+
+// Properties of the commands that are relevant to routing and
+// splitting, commands not listed have none. Must be kept sorted.
+constexpr std::array<command_info, 107> commands =
+{{
+   {"BITCOUNT", read_only}, {"BITFIELD_RO", read_only},
+   {"BITPOS", read_only}, {"BLMOVE", blocking}, {"BLMPOP", blocking},
+   {"BLPOP", blocking}, {"BRPOP", blocking}, {"BRPOPLPUSH", blocking},
+   {"BZMPOP", blocking}, {"BZPOPMAX", blocking}, {"BZPOPMIN", blocking},
+   {"DBSIZE", read_only}, {"DEL", split_sum | no_leading_key},
+   {"DUMP", read_only}, {"ECHO", read_only}, {"EVALSHA_RO", read_only},
+   {"EVAL_RO", read_only},
+   {"EXISTS", read_only | split_sum | no_leading_key},
+   {"EXPIRETIME", read_only}, {"FCALL_RO", read_only},
+   {"GEODIST", read_only}, {"GEOHASH", read_only},
+   {"GEOPOS", read_only}, {"GEORADIUSBYMEMBER_RO", read_only},
+   {"GEORADIUS_RO", read_only}, {"GEOSEARCH", read_only},
+   {"GET", read_only}, {"GETBIT", read_only}, {"GETRANGE", read_only},
+   {"HDEL", split_sum}, {"HEXISTS", read_only}, {"HGET", read_only},
+   {"HGETALL", read_only}, {"HKEYS", read_only}, {"HLEN", read_only},
+   {"HMGET", read_only | split_concat}, {"HRANDFIELD", read_only},
+   {"HSCAN", read_only}, {"HSET", split_sum | split_pairs}, {"HSTRLEN", read_only},
+   {"HVALS", read_only}, {"KEYS", read_only}, {"LCS", read_only},
+   {"LINDEX", read_only}, {"LLEN", read_only}, {"LPOS", read_only},
+   {"LPUSH", split_last}, {"LRANGE", read_only},
+   {"MGET", read_only | split_concat | no_leading_key},
+   {"MSET", split_ok | no_leading_key | split_pairs}, {"OBJECT", read_only},
+   {"PEXPIRETIME", read_only}, {"PFCOUNT", read_only},
+   {"PING", read_only}, {"PTTL", read_only}, {"RANDOMKEY", read_only},
+   {"RPUSH", split_last}, {"SADD", split_sum}, {"SCAN", read_only},
+   {"SCARD", read_only}, {"SDIFF", read_only}, {"SINTER", read_only},
+   {"SINTERCARD", read_only}, {"SISMEMBER", read_only},
+   {"SMEMBERS", read_only}, {"SMISMEMBER", read_only | split_concat},
+   {"SORT_RO", read_only}, {"SRANDMEMBER", read_only},
+   {"SREM", split_sum}, {"SSCAN", read_only}, {"STRLEN", read_only},
+   {"SUBSTR", read_only}, {"SUNION", read_only},
+   {"TOUCH", split_sum | no_leading_key}, {"TTL", read_only},
+   {"TYPE", read_only}, {"UNLINK", split_sum | no_leading_key},
+   {"WAIT", blocking}, {"WAITAOF", blocking}, {"XINFO", read_only},
+   {"XLEN", read_only}, {"XPENDING", read_only}, {"XRANGE", read_only},
+   {"XREAD", blocking_option}, {"XREADGROUP", blocking_option},
+   {"XREVRANGE", read_only}, {"ZADD", split_sum | split_pairs}, {"ZCARD", read_only},
+   {"ZCOUNT", read_only}, {"ZDIFF", read_only}, {"ZINTER", read_only},
+   {"ZINTERCARD", read_only}, {"ZLEXCOUNT", read_only},
+   {"ZMSCORE", read_only | split_concat}, {"ZRANDMEMBER", read_only},
+   {"ZRANGE", read_only}, {"ZRANGEBYLEX", read_only},
+   {"ZRANGEBYSCORE", read_only}, {"ZRANK", read_only},
+   {"ZREM", split_sum}, {"ZREVRANGE", read_only},
+   {"ZREVRANGEBYLEX", read_only}, {"ZREVRANGEBYSCORE", read_only},
+   {"ZREVRANK", read_only}, {"ZSCAN", read_only}, {"ZSCORE", read_only},
+   {"ZUNION", read_only}
+}};
+
+auto icase_less(std::string_view a, std::string_view b) -> bool
+{
+   return std::lexicographical_compare(
+      std::cbegin(a), std::cend(a), std::cbegin(b), std::cend(b),
+      [](char c1, char c2) {
+         return std::toupper(static_cast<unsigned char>(c1)) < std::toupper(static_cast<unsigned char>(c2));
+      });
+}
+
+} // anonymous
+
+auto get_command_flags(std::string_view cmd) -> command_flags
+{
+   auto const iter = std::lower_bound(std::cbegin(commands), std::cend(commands), cmd, [](auto const& e, auto c) {
+      return icase_less(e.name, c);
+   });
+
+   if (iter == std::cend(commands) || icase_less(cmd, iter->name))
+      return command_flags::none;
+
+   return iter->flags;
+}
+
+auto is_read_only(std::string_view cmd) -> bool
+{
+   return (get_command_flags(cmd) & command_flags::read_only) != command_flags::none;
+}
+
+auto has_block_option(std::string_view cmd) -> bool
+{
+   // Skips the array header and visits the bulk strings, options come
+   // before STREAMS, which is followed by keys and ids.
+   auto pos = cmd.find("\r\n");
+   while (pos != std::string_view::npos) {
+      pos += 2;
+      if (pos >= std::size(cmd) || cmd[pos] != '$')
+         return false;
+
+      auto const end = cmd.find("\r\n", pos);
+      if (end == std::string_view::npos)
+         return false;
+
+      std::size_t len = 0;
+      auto const res = std::from_chars(cmd.data() + pos + 1, cmd.data() + end, len);
+      if (res.ec != std::errc{})
+         return false;
+
+      auto const arg = cmd.substr(end + 2, len);
+      if (!icase_less(arg, "BLOCK") && !icase_less("BLOCK", arg))
+         return true;
+
+      if (!icase_less(arg, "STREAMS") && !icase_less("STREAMS", arg))
+         return false;
+
+      pos = end + 2 + len;
+   }
+
+   return false;
+}
+
 } // boost:redis::detail
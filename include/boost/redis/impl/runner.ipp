@@ -22,6 +22,8 @@ void push_hello(config const& cfg, request& req)
 
    if (cfg.database_index && cfg.database_index.value() != 0)
       req.push("SELECT", cfg.database_index.value());
+
+   req.append(cfg.setup);
 }
 
 } // boost::redis::detail
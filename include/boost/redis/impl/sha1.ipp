@@ -0,0 +1,108 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/sha1.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace boost::redis::detail
+{
+
+namespace
+{
+
+auto rotl(std::uint32_t x, int n) noexcept -> std::uint32_t
+{
+   return (x << n) | (x >> (32 - n));
+}
+
+void sha1_block(std::array<std::uint32_t, 5>& h, unsigned char const* block) noexcept
+{
+   std::array<std::uint32_t, 80> w{};
+   for (std::size_t i = 0; i < 16; ++i) {
+      w[i] =
+         (std::uint32_t{block[4 * i]} << 24) |
+         (std::uint32_t{block[4 * i + 1]} << 16) |
+         (std::uint32_t{block[4 * i + 2]} << 8) |
+         std::uint32_t{block[4 * i + 3]};
+   }
+
+   for (std::size_t i = 16; i < 80; ++i)
+      w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+   auto a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+   for (std::size_t i = 0; i < 80; ++i) {
+      std::uint32_t f = 0;
+      std::uint32_t k = 0;
+      if (i < 20) {
+         f = (b & c) | (~b & d);
+         k = 0x5A827999;
+      } else if (i < 40) {
+         f = b ^ c ^ d;
+         k = 0x6ED9EBA1;
+      } else if (i < 60) {
+         f = (b & c) | (b & d) | (c & d);
+         k = 0x8F1BBCDC;
+      } else {
+         f = b ^ c ^ d;
+         k = 0xCA62C1D6;
+      }
+
+      auto const tmp = rotl(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rotl(b, 30);
+      b = a;
+      a = tmp;
+   }
+
+   h[0] += a;
+   h[1] += b;
+   h[2] += c;
+   h[3] += d;
+   h[4] += e;
+}
+
+} // namespace
+
+auto sha1_hex(std::string_view data) -> std::string
+{
+   std::array<std::uint32_t, 5> h{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+   auto const* p = reinterpret_cast<unsigned char const*>(data.data());
+   auto const size = std::size(data);
+   std::size_t i = 0;
+   for (; i + 64 <= size; i += 64)
+      sha1_block(h, p + i);
+
+   // The remaining bytes, the padding and the length in bits.
+   std::array<unsigned char, 128> tail{};
+   auto const rest = size - i;
+   for (std::size_t j = 0; j < rest; ++j)
+      tail[j] = p[i + j];
+
+   tail[rest] = 0x80;
+   std::size_t const tail_size = rest < 56 ? 64 : 128;
+   auto const bits = static_cast<std::uint64_t>(size) * 8;
+   for (std::size_t j = 0; j < 8; ++j)
+      tail[tail_size - 1 - j] = static_cast<unsigned char>(bits >> (8 * j));
+
+   for (std::size_t j = 0; j < tail_size; j += 64)
+      sha1_block(h, tail.data() + j);
+
+   constexpr char digits[] = "0123456789abcdef";
+   std::string ret;
+   ret.reserve(40);
+   for (auto v : h) {
+      for (int shift = 28; shift >= 0; shift -= 4)
+         ret += digits[(v >> shift) & 0xF];
+   }
+
+   return ret;
+}
+
+} // boost::redis::detail
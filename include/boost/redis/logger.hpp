@@ -8,6 +8,7 @@
 #define BOOST_REDIS_LOGGER_HPP
 
 #include <boost/redis/response.hpp>
+#include <boost/redis/config.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <string>
 
@@ -76,6 +77,16 @@ public:
     */
    void on_resolve(system::error_code const& ec, asio::ip::tcp::resolver::results_type const& res);
 
+   /** @brief Called when the master address is resolved with sentinels.
+    *  @ingroup high-level-api
+    *
+    *  Called also when a failover is announced by a sentinel.
+    *
+    *  @param ec Error returned by the resolve operation.
+    *  @param addr Address of the master.
+    */
+   void on_sentinel_resolve(system::error_code const& ec, address const& addr);
+
    /** @brief Called when the connect operation completes.
     *  @ingroup high-level-api
     *
@@ -125,6 +136,10 @@ public:
    /** @brief Called when the `HELLO` request completes.
     *  @ingroup high-level-api
     *
+    *  The request contains also the commands in
+    *  `boost::redis::config::setup`, whose errors are reported here as
+    *  well.
+    *
     *  @param ec Error code returned by the async_exec operation.
     *  @param resp Response sent by the Redis server.
     */
@@ -0,0 +1,531 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_REPLICATED_CONNECTION_HPP
+#define BOOST_REDIS_REPLICATED_CONNECTION_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/detail/helper.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/logger.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+template <class Conn, class Logger>
+struct replicated_run_op {
+   Conn* conn_ = nullptr;
+   Logger logger_;
+   system::error_code run_ec_{};
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {})
+   {
+      BOOST_ASIO_CORO_REENTER (coro_)
+      {
+         conn_->start_replicas(logger_);
+
+         // The primary connection drives the lifetime of the whole
+         // operation.
+         BOOST_ASIO_CORO_YIELD
+         conn_->primary_.async_run(conn_->cfg_, logger_, std::move(self));
+         run_ec_ = ec;
+
+         // Waits for the replicas to finish as well.
+         conn_->cancel_replicas();
+         conn_->timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+         while (conn_->pending_runs_ != 0) {
+            BOOST_ASIO_CORO_YIELD
+            conn_->timer_.async_wait(std::move(self));
+         }
+
+         self.complete(run_ec_);
+      }
+   }
+};
+
+// State shared between a hedged exec and the individual execs it
+// starts. Outlives the hedged exec when the loser is still pending,
+// that is why the request and responses are copies.
+template <class Response, class Timer>
+struct hedge_state {
+   template <class Executor>
+   hedge_state(Executor ex, request const& r)
+   : req{r}
+   , timer{ex}
+   { }
+
+   request req;
+   std::array<Response, 2> resps{};
+   std::array<system::error_code, 2> ecs{};
+   std::array<std::size_t, 2> sizes{};
+   std::size_t launched = 0;
+   std::size_t finished = 0;
+   std::optional<std::size_t> winner;
+   Timer timer;
+   std::array<asio::cancellation_signal, 2> signals;
+
+   [[nodiscard]] bool done() const noexcept
+      { return winner.has_value() || finished == launched; }
+
+   // Cancels the execs that are still pending.
+   void cancel()
+   {
+      for (std::size_t i = 0; i < launched; ++i)
+         signals[i].emit(asio::cancellation_type::terminal);
+   }
+
+   template <class Connection>
+   static void launch(std::shared_ptr<hedge_state> st, Connection& conn)
+   {
+      auto const i = st->launched++;
+      auto f = [st, i](system::error_code ec, std::size_t n)
+      {
+         st->ecs[i] = ec;
+         st->sizes[i] = n;
+         ++st->finished;
+
+         // The first successful reply wins.
+         if (!ec && !st->winner)
+            st->winner = i;
+
+         st->timer.cancel();
+      };
+
+      conn.async_exec(st->req, st->resps[i], asio::bind_cancellation_slot(st->signals[i].slot(), std::move(f)));
+   }
+};
+
+template <class Conn, class Response>
+struct hedged_exec_op {
+   using state_type = hedge_state<Response, typename Conn::timer_type>;
+
+   Conn* conn_ = nullptr;
+   request const* req_ = nullptr;
+   Response* resp_ = nullptr;
+   std::shared_ptr<state_type> st_ = nullptr;
+   typename Conn::connection_type* first_ = nullptr;
+   bool hedge_ = false;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro_)
+      {
+         if (!conn_->is_hedgeable(*req_)) {
+            BOOST_ASIO_CORO_YIELD
+            conn_->select(*req_).async_exec(*req_, *resp_, std::move(self));
+            self.complete(ec, n);
+            return;
+         }
+
+         st_ = std::make_shared<state_type>(conn_->get_executor(), *req_);
+         first_ = &conn_->select(*req_);
+         state_type::launch(st_, *first_);
+
+         // Without enough samples the delay would be meaningless.
+         hedge_ = conn_->can_hedge(*first_);
+         if (hedge_) {
+            st_->timer.expires_after(conn_->hedge_delay(*first_));
+            BOOST_ASIO_CORO_YIELD
+            st_->timer.async_wait(std::move(self));
+            if (is_cancelled(self)) {
+               st_->cancel();
+               self.complete(asio::error::operation_aborted, 0);
+               return;
+            }
+         }
+
+         if (hedge_ && !st_->done()) {
+            if (auto* other = conn_->select_other(*first_); other != nullptr) {
+               conn_->on_hedge();
+               state_type::launch(st_, *other);
+            }
+         }
+
+         // The timer is used as a condition variable notified by the
+         // individual execs, see hedge_state::launch.
+         st_->timer.expires_at((std::chrono::steady_clock::time_point::max)());
+         while (!st_->done()) {
+            BOOST_ASIO_CORO_YIELD
+            st_->timer.async_wait(std::move(self));
+            if (is_cancelled(self)) {
+               st_->cancel();
+               self.complete(asio::error::operation_aborted, 0);
+               return;
+            }
+         }
+
+         // The loser is not needed anymore.
+         st_->cancel();
+
+         {
+            // All failed: reports the error of the first exec.
+            auto const i = st_->winner.value_or(0);
+            if (i == 1)
+               conn_->on_hedge_won();
+
+            *resp_ = std::move(st_->resps[i]);
+            self.complete(st_->ecs[i], st_->sizes[i]);
+         }
+      }
+   }
+};
+
+} // detail
+
+/** @brief A connection to a primary and its replicas.
+ *  @ingroup high-level-api
+ *
+ *  Keeps one `boost::redis::basic_connection` to the primary at
+ *  `boost::redis::config::addr` and one to each replica in
+ *  `boost::redis::config::replicas`. Requests that contain only
+ *  read-only commands (see `boost::redis::request::is_read_only`)
+ *  are sent to the replica selected by
+ *  `boost::redis::replica_config::selection` among those that are
+ *  connected, all other requests are sent to the primary. Set
+ *  `boost::redis::request::config::read_from_primary` on requests
+ *  that can't tolerate stale reads.
+ *
+ *  Server pushes are received on the primary connection only.
+ *
+ *  @tparam Executor The executor type.
+ */
+template <class Executor>
+class basic_replicated_connection {
+public:
+   /// Executor type.
+   using executor_type = Executor;
+
+   /// Type of the connection to each node.
+   using connection_type = basic_connection<Executor>;
+
+   /// Returns the underlying executor.
+   executor_type get_executor() noexcept
+      { return primary_.get_executor(); }
+
+   /** @brief Constructor
+    *
+    *  @param ex Executor on which connection operation will run.
+    *  @param ctx SSL context, shared by the primary and the replicas.
+    *  @param max_read_size Maximum read size that is passed to
+    *  the internal `asio::dynamic_buffer` constructor.
+    */
+   explicit
+   basic_replicated_connection(
+      executor_type ex,
+      asio::ssl::context ctx = asio::ssl::context{asio::ssl::context::tlsv12_client},
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)())
+   : primary_{ex, std::move(ctx), max_read_size}
+   , timer_{ex}
+   , max_read_size_{max_read_size}
+   { }
+
+   /// Contructs from a context.
+   explicit
+   basic_replicated_connection(
+      asio::io_context& ioc,
+      asio::ssl::context ctx = asio::ssl::context{asio::ssl::context::tlsv12_client},
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)())
+   : basic_replicated_connection(ioc.get_executor(), std::move(ctx), max_read_size)
+   { }
+
+   /** @brief Constructor with a shared SSL context.
+    *
+    *  See `boost::redis::basic_connection::share_ssl_context`.
+    */
+   basic_replicated_connection(
+      executor_type ex,
+      std::shared_ptr<asio::ssl::context> ctx,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)())
+   : primary_{ex, std::move(ctx), max_read_size}
+   , timer_{ex}
+   , max_read_size_{max_read_size}
+   { }
+
+   /** @brief Starts the connections to the primary and replicas.
+    *
+    *  See `boost::redis::basic_connection::async_run`. Each replica
+    *  is reconnected independently. The operation completes when
+    *  the primary connection's `async_run` completes, after the
+    *  replica connections have been cancelled.
+    *
+    *  @param cfg Configuration paramters.
+    *  @param l Logger object.
+    *  @param token Completion token with signature `void(system::error_code)`.
+    */
+   template <
+      class Logger = logger,
+      class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto
+   async_run(
+      config const& cfg = {},
+      Logger l = Logger{},
+      CompletionToken token = CompletionToken{})
+   {
+      using this_type = basic_replicated_connection<executor_type>;
+
+      cfg_ = cfg;
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::replicated_run_op<this_type, Logger>{this, l}, token, timer_);
+   }
+
+   /** @brief Executes a request on the primary or on a replica.
+    *
+    *  See `boost::redis::basic_connection::async_exec`.
+    */
+   template <
+      class Response = ignore_t,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec(
+      request const& req,
+      Response& resp = ignore,
+      CompletionToken&& token = CompletionToken{})
+   {
+      return select(req).async_exec(req, resp, std::forward<CompletionToken>(token));
+   }
+
+   /** @brief Executes a request with hedging.
+    *
+    *  Behaves like `async_exec` but, if the request is read-only and
+    *  hasn't completed after a delay derived from the latency
+    *  distribution of the selected connection (see
+    *  `boost::redis::replica_config::hedge_percentile`), a duplicate
+    *  is sent to another connected node. The first successful reply
+    *  is stored in `resp` and the other one is discarded.
+    *
+    *  Requests that are not read-only or that have
+    *  `boost::redis::request::config::read_from_primary` set are
+    *  never duplicated. Since the duplicate may outlive this
+    *  operation, the request is copied.
+    *
+    *  @param req Request.
+    *  @param resp Response, must be default constructible and move assignable.
+    *  @param token Completion token with signature `void(system::error_code, std::size_t)`.
+    */
+   template <
+      class Response = ignore_t,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec_hedged(
+      request const& req,
+      Response& resp = ignore,
+      CompletionToken token = CompletionToken{})
+   {
+      using this_type = basic_replicated_connection<executor_type>;
+
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::hedged_exec_op<this_type, Response>{this, &req, &resp}, token, timer_);
+   }
+
+   /// Returns the number of duplicates sent by `async_exec_hedged`.
+   std::size_t get_hedged_requests() const noexcept
+      { return hedged_requests_; }
+
+   /// Returns the number of times the duplicate replied first.
+   std::size_t get_hedges_won() const noexcept
+      { return hedges_won_; }
+
+   /// Calls `boost::redis::basic_connection::async_receive` on the primary.
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_receive(CompletionToken token = CompletionToken{})
+      { return primary_.async_receive(std::move(token)); }
+
+   /// Calls `boost::redis::basic_connection::set_receive_response` on the primary.
+   template <class Response>
+   void set_receive_response(Response& response)
+      { primary_.set_receive_response(response); }
+
+   /// Cancels operations on the primary and on all replicas.
+   void cancel(operation op = operation::all)
+   {
+      primary_.cancel(op);
+      for (auto& conn : replicas_)
+         conn->cancel(op);
+   }
+
+   /// Returns the connection to the primary.
+   auto& primary() noexcept
+      { return primary_; }
+
+   /// Returns the number of replicas.
+   std::size_t replicas() const noexcept
+      { return std::size(replicas_); }
+
+   /// Returns the connection to the i-th replica.
+   auto& replica(std::size_t i)
+      { return *replicas_.at(i); }
+
+   /** @brief Returns the connection a request would be sent to.
+    *
+    *  Falls back to the primary when no replica is connected.
+    */
+   connection_type& select(request const& req)
+   {
+      if (!req.is_read_only() || req.get_config().read_from_primary)
+         return primary_;
+
+      connection_type* best = nullptr;
+      for (auto& conn : replicas_) {
+         if (!conn->is_ready())
+            continue;
+
+         if (best == nullptr || is_better(*conn, *best))
+            best = conn.get();
+      }
+
+      return best == nullptr ? primary_ : *best;
+   }
+
+private:
+   using timer_type =
+      asio::basic_waitable_timer<
+         std::chrono::steady_clock,
+         asio::wait_traits<std::chrono::steady_clock>,
+         Executor>;
+
+   template <class, class> friend struct detail::replicated_run_op;
+   template <class, class> friend struct detail::hedged_exec_op;
+
+   bool is_hedgeable(request const& req) const noexcept
+      { return req.is_read_only() && !req.get_config().read_from_primary; }
+
+   bool can_hedge(connection_type const& conn) const noexcept
+      { return conn.get_latency_samples() >= cfg_.replicas.hedge_min_samples; }
+
+   auto hedge_delay(connection_type const& conn) const noexcept
+   {
+      return (std::max)(
+         conn.get_latency_percentile(cfg_.replicas.hedge_percentile),
+         cfg_.replicas.hedge_min_delay);
+   }
+
+   // Returns the best connected node other than the excluded one,
+   // the primary included.
+   connection_type* select_other(connection_type const& excluded)
+   {
+      connection_type* best = nullptr;
+      for (auto& conn : replicas_) {
+         if (conn.get() == &excluded || !conn->is_ready())
+            continue;
+
+         if (best == nullptr || is_better(*conn, *best))
+            best = conn.get();
+      }
+
+      if (best == nullptr && &primary_ != &excluded && primary_.is_ready())
+         best = &primary_;
+
+      return best;
+   }
+
+   void on_hedge() noexcept
+      { ++hedged_requests_; }
+
+   void on_hedge_won() noexcept
+      { ++hedges_won_; }
+
+   bool is_better(connection_type const& a, connection_type const& b) const noexcept
+   {
+      auto const a_lat = a.get_average_latency();
+      auto const b_lat = b.get_average_latency();
+      auto const a_out = a.get_outstanding_requests();
+      auto const b_out = b.get_outstanding_requests();
+
+      if (cfg_.replicas.selection == replica_selection::fewest_outstanding)
+         return a_out < b_out || (a_out == b_out && a_lat < b_lat);
+
+      return a_lat < b_lat || (a_lat == b_lat && a_out < b_out);
+   }
+
+   template <class Logger>
+   void start_replicas(Logger l)
+   {
+      auto const n = std::size(cfg_.replicas.addresses);
+      while (std::size(replicas_) < n) {
+         replicas_.push_back(
+            std::make_unique<connection_type>(
+               primary_.get_executor(),
+               primary_.share_ssl_context(),
+               max_read_size_));
+      }
+
+      replica_cfgs_.resize(n);
+      for (std::size_t i = 0; i < n; ++i) {
+         auto& cfg = replica_cfgs_[i];
+         cfg = cfg_;
+         cfg.addr = cfg_.replicas.addresses[i];
+         cfg.sentinel.addresses.clear();
+         cfg.replicas.addresses.clear();
+         cfg.log_prefix += "(replica " + std::to_string(i) + ") ";
+
+         cfg.setup.clear();
+         if (cfg_.replicas.send_readonly)
+            cfg.setup.push("READONLY");
+         cfg.setup.append(cfg_.setup);
+
+         ++pending_runs_;
+         replicas_[i]->reset_stream();
+         replicas_[i]->async_run(cfg, l, [this](system::error_code)
+         {
+            --pending_runs_;
+            timer_.cancel();
+         });
+      }
+   }
+
+   void cancel_replicas()
+   {
+      for (auto& conn : replicas_)
+         conn->cancel(operation::all);
+   }
+
+   config cfg_;
+   connection_type primary_;
+   std::vector<std::unique_ptr<connection_type>> replicas_;
+   std::vector<config> replica_cfgs_;
+   timer_type timer_;
+   std::size_t max_read_size_;
+   std::size_t pending_runs_ = 0;
+   std::size_t hedged_requests_ = 0;
+   std::size_t hedges_won_ = 0;
+};
+
+/// A replicated connection that uses `asio::any_io_executor`.
+using replicated_connection = basic_replicated_connection<asio::any_io_executor>;
+
+} // boost::redis
+
+#endif // BOOST_REDIS_REPLICATED_CONNECTION_HPP
@@ -10,9 +10,11 @@
 #include <boost/redis/resp3/type.hpp>
 #include <boost/redis/resp3/serialization.hpp>
 
+#include <chrono>
 #include <string>
 #include <tuple>
 #include <algorithm>
+#include <iterator>
 
 // NOTE: For some commands like hset it would be a good idea to assert
 // the value type is a pair.
@@ -20,9 +22,52 @@
 namespace boost::redis {
 
 namespace detail{
+enum class command_flags : unsigned short
+{ none = 0
+, read_only = 1
+, blocking = 2
+  // Blocks only when the BLOCK option is present e.g. XREAD.
+, blocking_option = 4
+  // How the responses to the parts of a split command are merged,
+  // see async_exec_split.
+, split_sum = 8
+, split_last = 16
+, split_concat = 32
+, split_ok = 64
+  // All arguments are keys e.g. MGET.
+, no_leading_key = 128
+  // Arguments come in pairs e.g. the field-value pairs of HSET.
+, split_pairs = 256
+};
+
+constexpr auto operator&(command_flags a, command_flags b) noexcept
+   { return static_cast<command_flags>(static_cast<unsigned>(a) & static_cast<unsigned>(b)); }
+
+constexpr auto operator|(command_flags a, command_flags b) noexcept
+   { return static_cast<command_flags>(static_cast<unsigned>(a) | static_cast<unsigned>(b)); }
+
 auto has_response(std::string_view cmd) -> bool;
+auto get_command_flags(std::string_view cmd) -> command_flags;
+auto is_read_only(std::string_view cmd) -> bool;
+auto has_block_option(std::string_view cmd) -> bool;
 }
 
+/** \brief Scheduling class of a request.
+ *  \ingroup high-level-api
+ *
+ *  See `boost::redis::request::config::priority`.
+ */
+enum class request_priority
+{
+   /// Latency sensitive requests, written before batch requests.
+   interactive,
+
+   /// Bulk requests, written after interactive requests and in
+   /// bounded amounts per write, see
+   /// `boost::redis::config::batch_max_bytes_per_write`.
+   batch,
+};
+
 /** \brief Creates Redis requests.
  *  \ingroup high-level-api
  *  
@@ -74,6 +119,53 @@ public:
        * commands are sent.
        */
       bool hello_with_priority = true;
+
+      /** \brief If `true` the request is sent to the primary even
+       * if it contains only read-only commands. Affects only
+       * `boost::redis::basic_replicated_connection`, use it when
+       * reading from a replica might return stale data that is not
+       * acceptable.
+       */
+      bool read_from_primary = false;
+
+      /** \brief Scheduling class of the request.
+       *
+       * Requests waiting to be written are ordered by class so that
+       * interactive requests are not delayed by large batch jobs.
+       * Since Redis replies in the order requests are written,
+       * reordering happens only before writing.
+       */
+      request_priority priority = request_priority::interactive;
+
+      /** \brief Identifies who issues the request.
+       *
+       * Waiting requests of the same class are written in round-robin
+       * order across producers and in FIFO order for the same
+       * producer. Any value can be used e.g. an id per coroutine.
+       */
+      std::size_t producer = 0;
+
+      /** \brief Time the request may wait in the queue before being written.
+       *
+       * If the request hasn't been written when the timeout expires
+       * it is removed from the queue and `connection::async_exec`
+       * completes with `boost::redis::error::request_timeout`.
+       * Requests that have been written are not affected. Pass zero
+       * for no timeout (the default).
+       */
+      std::chrono::steady_clock::duration timeout = std::chrono::steady_clock::duration::zero();
+
+      /** \brief If `true` the server won't reply to the commands
+       * pushed while this flag is set.
+       *
+       * Each such command is preceded by `CLIENT REPLY SKIP` and is
+       * not counted in the expected responses, so nothing has to be
+       * read or parsed for it. A request whose commands are all
+       * pushed this way completes as soon as it has been written.
+       * Useful for commands whose reply is ignored anyway e.g.
+       * `INCRBY` on metrics counters.
+       */
+      bool no_reply = false;
    };
 
    /** \brief Constructor
@@ -81,7 +173,7 @@ public:
     *  \param cfg Configuration options.
     */
     explicit
-    request(config cfg = config{true, false, true, true})
+    request(config cfg = config{true, false, true, true, false, request_priority::interactive, 0, std::chrono::steady_clock::duration::zero(), false})
     : cfg_{cfg} {}
 
     //// Returns the number of responses expected for this request.
@@ -98,6 +190,18 @@ public:
    [[nodiscard]] auto has_hello_priority() const noexcept -> auto const&
       { return has_hello_priority_;}
 
+   /// Returns true if the request is not empty and all of its commands are read-only.
+   [[nodiscard]] auto is_read_only() const noexcept -> bool
+      { return commands_ != 0 && is_read_only_;}
+
+   /** @brief Returns true if the request contains a blocking command.
+    *
+    *  Blocking commands are e.g. `BLPOP`, `WAIT` or `XREAD` with the
+    *  `BLOCK` option, see `boost::redis::config::blocking_connections`.
+    */
+   [[nodiscard]] auto is_blocking() const noexcept -> bool
+      { return is_blocking_;}
+
    /// Clears the request preserving allocated memory.
    void clear()
    {
@@ -105,12 +209,30 @@ public:
       commands_ = 0;
       expected_responses_ = 0;
       has_hello_priority_ = false;
+      is_read_only_ = true;
+      is_blocking_ = false;
    }
 
    /// Calls std::string::reserve on the internal storage.
    void reserve(std::size_t new_cap = 0)
       { payload_.reserve(new_cap); }
 
+   /** @brief Appends the commands of another request to this one.
+    *
+    *  The configuration of `other` is not taken into account.
+    *
+    *  @param other The request whose commands are appended.
+    */
+   void append(request const& other)
+   {
+      payload_ += other.payload_;
+      commands_ += other.commands_;
+      expected_responses_ += other.expected_responses_;
+      has_hello_priority_ = has_hello_priority_ || other.has_hello_priority_;
+      is_read_only_ = is_read_only_ && other.is_read_only_;
+      is_blocking_ = is_blocking_ || other.is_blocking_;
+   }
+
    /// Returns a const reference to the config object.
    [[nodiscard]] auto get_config() const noexcept -> auto const& {return cfg_; }
 
@@ -146,11 +268,12 @@ public:
    void push(std::string_view cmd, Ts const&... args)
    {
       auto constexpr pack_size = sizeof...(Ts);
+      auto const pos = prepare_cmd();
       resp3::add_header(payload_, resp3::type::array, 1 + pack_size);
       resp3::add_bulk(payload_, cmd);
       resp3::add_bulk(payload_, std::tie(std::forward<Ts const&>(args)...));
 
-      check_cmd(cmd);
+      check_cmd(cmd, pos);
    }
 
    /** @brief Appends a new command to the end of the request.
@@ -200,6 +323,7 @@ public:
 
       auto constexpr size = resp3::bulk_counter<value_type>::size;
       auto const distance = std::distance(begin, end);
+      auto const pos = prepare_cmd();
       resp3::add_header(payload_, resp3::type::array, 2 + size * distance);
       resp3::add_bulk(payload_, cmd);
       resp3::add_bulk(payload_, key);
@@ -207,7 +331,7 @@ public:
       for (; begin != end; ++begin)
 	 resp3::add_bulk(payload_, *begin);
 
-      check_cmd(cmd);
+      check_cmd(cmd, pos);
    }
 
    /** @brief Appends a new command to the end of the request.
@@ -252,13 +376,14 @@ public:
 
       auto constexpr size = resp3::bulk_counter<value_type>::size;
       auto const distance = std::distance(begin, end);
+      auto const pos = prepare_cmd();
       resp3::add_header(payload_, resp3::type::array, 1 + size * distance);
       resp3::add_bulk(payload_, cmd);
 
       for (; begin != end; ++begin)
 	 resp3::add_bulk(payload_, *begin);
 
-      check_cmd(cmd);
+      check_cmd(cmd, pos);
    }
 
    /** @brief Appends a new command to the end of the request.
@@ -305,16 +430,76 @@ public:
       push_range(cmd, cbegin(range), cend(range));
    }
 
+   /** @brief Appends an `EVALSHA` command to the end of the request.
+    *
+    *  Calls the script with the given SHA1 digest, see
+    *  `boost::redis::script`. For example
+    *
+    *  @code
+    *  std::array<std::string, 1> keys{"counter"};
+    *  std::array<int, 1> args{10};
+    *
+    *  request req;
+    *  req.push_evalsha(s.sha1(), keys, args);
+    *  @endcode
+    *
+    *  \param sha1 SHA1 digest of the script.
+    *  \param keys Range of keys passed to the script.
+    *  \param args Range of arguments passed to the script.
+    */
+   template <class Keys, class Args>
+   void push_evalsha(std::string_view sha1, Keys const& keys, Args const& args)
+   {
+      using std::cbegin;
+      using std::cend;
+      using key_type = typename std::iterator_traits<decltype(cbegin(keys))>::value_type;
+      using arg_type = typename std::iterator_traits<decltype(cbegin(args))>::value_type;
+
+      auto const nkeys = resp3::bulk_counter<key_type>::size * static_cast<std::size_t>(std::distance(cbegin(keys), cend(keys)));
+      auto const nargs = resp3::bulk_counter<arg_type>::size * static_cast<std::size_t>(std::distance(cbegin(args), cend(args)));
+      auto const pos = prepare_cmd();
+      resp3::add_header(payload_, resp3::type::array, 3 + nkeys + nargs);
+      resp3::add_bulk(payload_, std::string_view{"EVALSHA"});
+      resp3::add_bulk(payload_, sha1);
+      resp3::add_bulk(payload_, nkeys);
+
+      for (auto const& key : keys)
+         resp3::add_bulk(payload_, key);
+
+      for (auto const& arg : args)
+         resp3::add_bulk(payload_, arg);
+
+      check_cmd("EVALSHA", pos);
+   }
+
 private:
-   void check_cmd(std::string_view cmd)
+   // Returns the position where the command starts.
+   auto prepare_cmd() -> std::size_t
+   {
+      if (cfg_.no_reply)
+         payload_ += "*3\r\n$6\r\nCLIENT\r\n$5\r\nREPLY\r\n$4\r\nSKIP\r\n";
+
+      return std::size(payload_);
+   }
+
+   void check_cmd(std::string_view cmd, std::size_t pos)
    {
       ++commands_;
 
-      if (!detail::has_response(cmd))
+      if (!cfg_.no_reply && !detail::has_response(cmd))
          ++expected_responses_;
 
       if (cmd == "HELLO")
          has_hello_priority_ = cfg_.hello_with_priority;
+
+      using detail::command_flags;
+      auto const flags = detail::get_command_flags(cmd);
+      is_read_only_ = is_read_only_ && (flags & command_flags::read_only) != command_flags::none;
+
+      if ((flags & command_flags::blocking) != command_flags::none)
+         is_blocking_ = true;
+      else if ((flags & command_flags::blocking_option) != command_flags::none)
+         is_blocking_ = is_blocking_ || detail::has_block_option(std::string_view{payload_}.substr(pos));
    }
 
    config cfg_;
@@ -322,6 +507,8 @@ private:
    std::size_t commands_ = 0;
    std::size_t expected_responses_ = 0;
    bool has_hello_priority_ = false;
+   bool is_read_only_ = true;
+   bool is_blocking_ = false;
 };
 
 } // boost::redis::resp3
@@ -0,0 +1,371 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SCANNER_HPP
+#define BOOST_REDIS_SCANNER_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/detail/helper.hpp>
+#include <boost/redis/detail/scan_page.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/core/span.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+template <class Scanner>
+struct scan_next_op {
+   Scanner* scanner_ = nullptr;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code = {})
+   {
+      BOOST_ASIO_CORO_REENTER (coro_)
+      {
+         // The page returned by the previous call is not needed
+         // anymore, its buffer can be used to fetch another.
+         scanner_->release_page();
+
+         if (scanner_->can_complete()) {
+            BOOST_ASIO_CORO_YIELD
+            asio::post(std::move(self));
+         }
+
+         while (!scanner_->can_complete()) {
+            BOOST_ASIO_CORO_YIELD
+            scanner_->timer_.async_wait(std::move(self));
+            if (is_cancelled(self)) {
+               self.complete(asio::error::operation_aborted, 0);
+               return;
+            }
+         }
+
+         if (scanner_->ec_) {
+            self.complete(scanner_->ec_, 0);
+            return;
+         }
+
+         self.complete({}, scanner_->take_page());
+      }
+   }
+};
+
+} // detail
+
+/** @brief Iterates over keys or elements with SCAN-like commands.
+ *  @ingroup high-level-api
+ *
+ *  Replaces the usual `async_exec` loop over cursors with calls to
+ *  `async_next`, for example
+ *
+ *  @code
+ *  scanner s{ex};
+ *  s.add_partition(conn, "user:*");
+ *  while (!s.is_done()) {
+ *     co_await s.async_next(asio::deferred);
+ *     for (auto const& key : s.get_keys())
+ *        ...
+ *  }
+ *  @endcode
+ *
+ *  The next page of each partition is fetched while the application
+ *  processes the current one. Elements are decoded into buffers that
+ *  are reused across pages.
+ *
+ *  The work can be split into partitions, each with its own cursor,
+ *  connection and filters, e.g. one per `TYPE` or `MATCH` pattern or
+ *  one per node. Partitions are scanned concurrently and their pages
+ *  are returned as they arrive, in round-robin order.
+ *
+ *  The scanner must outlive all operations it starts, including the
+ *  fetches of partitions, i.e. it should only be destroyed after
+ *  `is_done` returns true.
+ *
+ *  @tparam Connection `boost::redis::connection` or `boost::redis::basic_connection`.
+ */
+template <class Connection>
+class basic_scanner {
+public:
+   /// Executor type.
+   using executor_type = typename Connection::executor_type;
+
+   /** @brief Constructor.
+    *
+    *  @param ex Executor.
+    *  @param cmd The command i.e. `SCAN`, `HSCAN`, `SSCAN` or `ZSCAN`.
+    *  @param key The key of the collection to scan, unused by `SCAN`.
+    *  @param count Value of the `COUNT` option i.e. the approximate page size.
+    */
+   explicit
+   basic_scanner(
+      executor_type ex,
+      std::string_view cmd = "SCAN",
+      std::string_view key = {},
+      std::size_t count = 1000)
+   : timer_{ex}
+   , cmd_{cmd}
+   , key_{key}
+   , count_{std::to_string(count)}
+   {
+      timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+   }
+
+   /** @brief Adds a partition of the work.
+    *
+    *  @param conn Connection used by this partition, must outlive the scanner.
+    *  @param match Value of the `MATCH` option, empty for none.
+    *  @param type Value of the `TYPE` option (`SCAN` only), empty for none.
+    *
+    *  Must be called before the first call to `async_next`.
+    */
+   void add_partition(Connection& conn, std::string_view match = {}, std::string_view type = {})
+   {
+      auto p = std::make_unique<partition>();
+      p->conn = &conn;
+      p->match = match;
+      p->type = type;
+      partitions_.push_back(std::move(p));
+   }
+
+   /** @brief Returns the next page.
+    *
+    *  Completes with the number of elements in the page, which can be
+    *  accessed with `get_keys` until the next call. An empty page
+    *  does not mean the scan is over, see `is_done`. Only one call
+    *  may be outstanding at a time.
+    *
+    *  The completion token must have the following signature
+    *
+    *  @code
+    *  void f(system::error_code, std::size_t);
+    *  @endcode
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_next(CompletionToken&& token = CompletionToken{})
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::scan_next_op<basic_scanner>{this}, token, timer_);
+   }
+
+   /** @brief Returns the elements of the current page.
+    *
+    *  For `HSCAN` and `ZSCAN` these are field-value and
+    *  member-score pairs in consecutive positions.
+    */
+   auto get_keys() const noexcept -> span<std::string const>
+   {
+      if (current_ == nullptr)
+         return {};
+
+      return {current_->elements.data(), current_->size};
+   }
+
+   /// Returns true when all partitions have been scanned or an error occurred and no fetch is pending.
+   bool is_done() const noexcept
+   {
+      for (auto const& p : partitions_) {
+         if (p->in_flight || (!ec_ && (!p->finished || p->has_ready())))
+            return false;
+      }
+
+      return true;
+   }
+
+   /// Stops the scan, pending fetches are cancelled.
+   void cancel()
+   {
+      if (!ec_)
+         ec_ = asio::error::operation_aborted;
+
+      for (auto& p : partitions_)
+         p->signal.emit(asio::cancellation_type::terminal);
+
+      timer_.cancel();
+   }
+
+private:
+   template <class> friend struct detail::scan_next_op;
+
+   using timer_type =
+      asio::basic_waitable_timer<
+         std::chrono::steady_clock,
+         asio::wait_traits<std::chrono::steady_clock>,
+         executor_type>;
+
+   enum class page_state
+   { free
+   , filling
+   , ready
+   , consumed
+   };
+
+   struct partition {
+      Connection* conn = nullptr;
+      std::string match;
+      std::string type;
+      std::string cursor{"0"};
+      bool finished = false;
+      bool in_flight = false;
+      request req;
+      std::array<detail::scan_page, 2> pages;
+      std::array<page_state, 2> states{page_state::free, page_state::free};
+      asio::cancellation_signal signal;
+
+      bool has_ready() const noexcept
+         { return states[0] == page_state::ready || states[1] == page_state::ready; }
+   };
+
+   bool can_complete() const noexcept
+   {
+      if (ec_)
+         return true;
+
+      for (auto const& p : partitions_) {
+         if (p->has_ready())
+            return true;
+      }
+
+      return is_done();
+   }
+
+   void release_page()
+   {
+      if (!started_) {
+         started_ = true;
+         for (auto& p : partitions_)
+            fetch(*p);
+      }
+
+      if (current_ == nullptr)
+         return;
+
+      auto& p = *partitions_.at(current_partition_);
+      p.states.at(current_page_) = page_state::free;
+      current_ = nullptr;
+      fetch(p);
+   }
+
+   auto take_page() -> std::size_t
+   {
+      auto const n = std::size(partitions_);
+      for (std::size_t k = 0; k < n; ++k) {
+         auto const i = (next_ + k) % n;
+         auto& p = *partitions_[i];
+         for (std::size_t j = 0; j < 2; ++j) {
+            if (p.states[j] != page_state::ready)
+               continue;
+
+            p.states[j] = page_state::consumed;
+            current_ = &p.pages[j];
+            current_partition_ = i;
+            current_page_ = j;
+            next_ = i + 1;
+
+            // Prefetches the next page while this one is processed.
+            fetch(p);
+            return current_->size;
+         }
+      }
+
+      return 0;
+   }
+
+   // Fetches the next page of a partition if it isn't finished and
+   // no other page is ahead of the application.
+   void fetch(partition& p)
+   {
+      if (ec_ || p.in_flight || p.finished || p.has_ready())
+         return;
+
+      std::size_t i = 0;
+      for (; i < 2 && p.states[i] != page_state::free; ++i);
+      if (i == 2)
+         return;
+
+      args_.clear();
+      if (!key_.empty())
+         args_.push_back(key_);
+      args_.push_back(p.cursor);
+      if (!p.match.empty()) {
+         args_.push_back("MATCH");
+         args_.push_back(p.match);
+      }
+      args_.push_back("COUNT");
+      args_.push_back(count_);
+      if (!p.type.empty()) {
+         args_.push_back("TYPE");
+         args_.push_back(p.type);
+      }
+
+      p.req.clear();
+      p.req.push_range(cmd_, args_);
+
+      p.pages[i].clear();
+      p.states[i] = page_state::filling;
+      p.in_flight = true;
+
+      auto f = [this, &p, i](system::error_code ec, std::size_t)
+      {
+         on_page(p, i, ec);
+      };
+
+      p.conn->async_exec(p.req, p.pages[i], asio::bind_cancellation_slot(p.signal.slot(), f));
+   }
+
+   void on_page(partition& p, std::size_t i, system::error_code ec)
+   {
+      p.in_flight = false;
+      if (ec) {
+         if (!ec_)
+            ec_ = ec;
+
+         p.states[i] = page_state::free;
+      } else {
+         p.cursor = p.pages[i].cursor;
+         p.finished = p.cursor == "0";
+         p.states[i] = page_state::ready;
+      }
+
+      timer_.cancel();
+   }
+
+   timer_type timer_;
+   std::string cmd_;
+   std::string key_;
+   std::string count_;
+   std::vector<std::unique_ptr<partition>> partitions_;
+   std::vector<std::string_view> args_;
+   system::error_code ec_;
+   bool started_ = false;
+   detail::scan_page const* current_ = nullptr;
+   std::size_t current_partition_ = 0;
+   std::size_t current_page_ = 0;
+   std::size_t next_ = 0;
+};
+
+/// A scanner that uses `boost::redis::connection`.
+using scanner = basic_scanner<connection>;
+
+} // boost::redis
+
+#endif // BOOST_REDIS_SCANNER_HPP
@@ -0,0 +1,219 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SCRIPT_HPP
+#define BOOST_REDIS_SCRIPT_HPP
+
+#include <boost/redis/config.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/redis/detail/evalsha_response.hpp>
+#include <boost/redis/detail/sha1.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace boost::redis {
+
+/** @brief A Lua script and its SHA1 digest.
+ *  @ingroup high-level-api
+ *
+ *  The digest is computed once, locally, so that the script can be
+ *  called with `EVALSHA` instead of sending its body on every call,
+ *  see `boost::redis::async_evalsha`.
+ */
+class script {
+public:
+   /// Constructor.
+   explicit script(std::string body)
+   : body_{std::move(body)}
+   , sha1_{detail::sha1_hex(body_)}
+   { }
+
+   /// Returns the body of the script.
+   [[nodiscard]] auto const& body() const noexcept
+      { return body_; }
+
+   /// Returns the SHA1 digest of the body as hex digits.
+   [[nodiscard]] auto const& sha1() const noexcept
+      { return sha1_; }
+
+private:
+   std::string body_;
+   std::string sha1_;
+};
+
+/** @brief A set of scripts that are loaded on every connection.
+ *  @ingroup high-level-api
+ *
+ *  See `preload`.
+ */
+class script_registry {
+public:
+   /** @brief Adds a script.
+    *
+    *  @param body The body of the script.
+    *  @returns The script, which remains valid as long as the
+    *  registry. Adding a script twice returns the same object.
+    */
+   script const& add(std::string body)
+   {
+      script s{std::move(body)};
+      auto const iter = std::find_if(std::cbegin(scripts_), std::cend(scripts_), [&s](auto const& e) {
+            return e.sha1() == s.sha1();
+      });
+
+      if (iter != std::cend(scripts_))
+         return *iter;
+
+      return scripts_.emplace_back(std::move(s));
+   }
+
+   /** @brief Loads the scripts as part of the connection setup.
+    *
+    *  Appends a `SCRIPT LOAD` for each script to
+    *  `boost::redis::config::setup` so that the scripts are in the
+    *  cache of the server before any other request is executed, also
+    *  after a reconnection e.g. to a restarted server. Calling it
+    *  again adds only the scripts that are not in the setup yet.
+    *
+    *  @note An error response to `SCRIPT LOAD` e.g. for a script that
+    *  doesn't compile or a user that isn't allowed to load scripts
+    *  fails the setup, which is handled like a failed `HELLO`: the
+    *  connection is closed and, if configured, retried, failing again
+    *  in the same way. Only preload scripts that are known to load,
+    *  e.g. that have been called with `async_evalsha` before.
+    */
+   void preload(config& cfg) const
+   {
+      request load;
+      for (auto const& s : scripts_) {
+         // Scripts already in the setup e.g. by a previous call are
+         // not loaded twice.
+         load.clear();
+         load.push("SCRIPT", "LOAD", s.body());
+         if (cfg.setup.payload().find(load.payload()) == std::string_view::npos)
+            cfg.setup.push("SCRIPT", "LOAD", s.body());
+      }
+   }
+
+   /// Returns the number of scripts.
+   [[nodiscard]] auto size() const noexcept
+      { return std::size(scripts_); }
+
+private:
+   std::deque<script> scripts_;
+};
+
+namespace detail
+{
+
+template <class Connection, class Response>
+struct evalsha_op {
+   struct state {
+      request req;
+      request retry;
+      Response resp;
+   };
+
+   Connection* conn_ = nullptr;
+   script const* script_ = nullptr;
+   std::unique_ptr<state> st_;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro_)
+      {
+         BOOST_ASIO_CORO_YIELD
+         conn_->async_exec(st_->req, st_->resp, std::move(self));
+         if (ec || !st_->resp.noscript) {
+            self.complete(ec, n);
+            return;
+         }
+
+         // The script is not in the cache of the server e.g. after
+         // SCRIPT FLUSH. It is loaded and called again in the same
+         // write.
+         st_->retry.get_config() = st_->req.get_config();
+         st_->retry.push("SCRIPT", "LOAD", script_->body());
+         st_->retry.append(st_->req);
+         st_->resp.skip = 1;
+         st_->resp.intercept = false;
+
+         BOOST_ASIO_CORO_YIELD
+         conn_->async_exec(st_->retry, st_->resp, std::move(self));
+         self.complete(ec, n);
+      }
+   }
+};
+
+} // detail
+
+/** @brief Calls a script with `EVALSHA`.
+ *  @ingroup high-level-api
+ *
+ *  Sends only the SHA1 digest of the script. If the server responds
+ *  with a `NOSCRIPT` error, the script is loaded with `SCRIPT LOAD`
+ *  and called again, transparently and on the same connection. If
+ *  loading fails e.g. because the script doesn't compile, the error
+ *  of `SCRIPT LOAD` is passed to the response instead. Use
+ *  `boost::redis::script_registry::preload` to avoid this round trip
+ *  after reconnections.
+ *
+ *  @param conn The connection.
+ *  @param s The script, must outlive the operation.
+ *  @param keys Range of keys passed to the script.
+ *  @param args Range of arguments passed to the script.
+ *  @param resp The response to the script.
+ *  @param token Completion token.
+ *
+ *  The completion token must have the following signature
+ *
+ *  @code
+ *  void f(system::error_code, std::size_t);
+ *  @endcode
+ */
+template <
+   class Connection,
+   class Keys,
+   class Args,
+   class Response,
+   class CompletionToken = asio::default_completion_token_t<typename Connection::executor_type>
+>
+auto
+async_evalsha(
+   Connection& conn,
+   script const& s,
+   Keys const& keys,
+   Args const& args,
+   Response& resp,
+   CompletionToken&& token = CompletionToken{})
+{
+   using namespace boost::redis::adapter;
+   using adapter_type = decltype(boost_redis_adapt(resp));
+   using response_type = detail::evalsha_response<adapter_type>;
+   using op_type = detail::evalsha_op<Connection, response_type>;
+
+   auto st = std::make_unique<typename op_type::state>(
+      typename op_type::state{request{}, request{}, response_type{boost_redis_adapt(resp)}});
+   st->req.push_evalsha(s.sha1(), keys, args);
+
+   return asio::async_compose
+      < CompletionToken
+      , void(system::error_code, std::size_t)
+      >(op_type{&conn, &s, std::move(st)}, token, conn);
+}
+
+} // boost::redis
+
+#endif // BOOST_REDIS_SCRIPT_HPP
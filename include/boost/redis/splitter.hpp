@@ -0,0 +1,263 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SPLITTER_HPP
+#define BOOST_REDIS_SPLITTER_HPP
+
+#include <boost/redis/error.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/redis/detail/split_merger.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace boost::redis {
+namespace detail
+{
+
+// Number of range elements that form one group of arguments of cmd,
+// e.g. two for the field-value pairs of HSET given as a flat range,
+// one if they are given as std::pair.
+inline auto get_split_unit(std::string_view cmd, std::size_t args_per_element) -> std::size_t
+{
+   std::size_t const group = (get_command_flags(cmd) & command_flags::split_pairs) != command_flags::none ? 2 : 1;
+   return (std::max)(group / args_per_element, std::size_t{1});
+}
+
+// Returns true if arg is an option of cmd. Options precede the
+// arguments that are split and are not supported, e.g. NX or CH would
+// be taken as a score-member pair of ZADD.
+inline auto is_split_option(std::string_view cmd, std::string_view arg) -> bool
+{
+   auto const iequal = [](std::string_view a, std::string_view b)
+   {
+      return std::size(a) == std::size(b) &&
+         std::equal(std::cbegin(a), std::cend(a), std::cbegin(b), [](char c1, char c2) {
+            return std::toupper(static_cast<unsigned char>(c1)) == std::toupper(static_cast<unsigned char>(c2));
+         });
+   };
+
+   if (!iequal(cmd, "ZADD"))
+      return false;
+
+   for (std::string_view opt : {"NX", "XX", "GT", "LT", "CH", "INCR"}) {
+      if (iequal(arg, opt))
+         return true;
+   }
+
+   return false;
+}
+
+// Returns true if the range starts with an option of cmd. Only flat
+// ranges can contain options.
+template <class ForwardIterator>
+auto starts_with_option(std::string_view cmd, ForwardIterator begin, ForwardIterator end) -> bool
+{
+   using value_type = std::decay_t<decltype(*begin)>;
+   if constexpr (resp3::bulk_counter<value_type>::size == 1) {
+      if (begin == end)
+         return false;
+
+      // The element serialized as a bulk string i.e. $<size>\r\n<data>\r\n
+      std::string bulk;
+      using resp3::boost_redis_to_bulk;
+      boost_redis_to_bulk(bulk, *begin);
+      auto const pos = bulk.find("\r\n");
+      if (pos == std::string::npos || std::size(bulk) < pos + 4)
+         return false;
+
+      return is_split_option(cmd, std::string_view{bulk}.substr(pos + 2, std::size(bulk) - pos - 4));
+   } else {
+      return false;
+   }
+}
+
+template <class Connection, class ForwardIterator, class Merger>
+struct exec_split_op {
+   struct state {
+      // max is rounded down to a multiple of unit so that groups of
+      // arguments are not split across parts.
+      state(std::string_view c, std::string_view k, ForwardIterator b, ForwardIterator e, std::size_t max, std::size_t unit, Merger m)
+      : cmd{c}, key{k}, begin{b}, end{e}, max_elements{(std::max)(max / unit, std::size_t{1}) * unit}, merger{std::move(m)}
+      { part.merger = &merger; }
+
+      // Writes the next part into req.
+      void next_part()
+      {
+         auto mid = begin;
+         for (std::size_t i = 0; mid != end && i < max_elements; ++i)
+            ++mid;
+
+         req.clear();
+         if ((get_command_flags(cmd) & command_flags::no_leading_key) != command_flags::none)
+            req.push_range(cmd, begin, mid);
+         else
+            req.push_range(cmd, key, begin, mid);
+
+         begin = mid;
+      }
+
+      std::string cmd;
+      std::string key;
+      ForwardIterator begin;
+      ForwardIterator end;
+      std::size_t max_elements;
+      Merger merger;
+      split_part<Merger> part;
+      request req;
+      std::size_t read_size = 0;
+   };
+
+   Connection* conn_ = nullptr;
+   std::unique_ptr<state> st_;
+   command_flags policy_ = command_flags::none;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro_)
+      {
+         if (policy_ == command_flags::none || st_->begin == st_->end) {
+            BOOST_ASIO_CORO_YIELD
+            asio::post(std::move(self));
+
+            if (policy_ == command_flags::none) {
+               self.complete(error::not_splittable, 0);
+               return;
+            }
+         }
+
+         // The parts are executed one after the other so that other
+         // requests are interleaved with them.
+         while (st_->begin != st_->end) {
+            st_->next_part();
+
+            BOOST_ASIO_CORO_YIELD
+            conn_->async_exec(st_->req, st_->part, std::move(self));
+            if (ec) {
+               self.complete(ec, 0);
+               return;
+            }
+
+            st_->read_size += n;
+            if (st_->merger.has_failed()) {
+               self.complete({}, st_->read_size);
+               return;
+            }
+         }
+
+         st_->merger.finish(ec);
+         self.complete(ec, st_->read_size);
+      }
+   }
+};
+
+} // detail
+
+/** @brief Executes a variadic command in parts of bounded size.
+ *  @ingroup high-level-api
+ *
+ *  A command such as `HSET` or `MSET` with millions of arguments
+ *  blocks the server while it executes, delaying all other clients.
+ *  This function splits the range into parts of at most
+ *  `max_elements` elements that are executed one after the other,
+ *  which allows other requests to be interleaved. The responses to the
+ *  parts are merged into `resp` as if the command had not been split:
+ *  counts are added (e.g. `SADD`, `DEL`), the last length is kept
+ *  (`RPUSH`, `LPUSH`), arrays are concatenated (e.g. `MGET`,
+ *  `HMGET`) and `MSET` yields a single `OK`.
+ *
+ *  Notice that the command is not atomic anymore.
+ *
+ *  @param conn The connection.
+ *  @param cmd The command: `DEL`, `EXISTS`, `HDEL`, `HMGET`, `HSET`,
+ *  `LPUSH`, `MGET`, `MSET`, `RPUSH`, `SADD`, `SMISMEMBER`, `SREM`,
+ *  `TOUCH`, `UNLINK`, `ZADD`, `ZMSCORE` or `ZREM`, other commands
+ *  complete with `boost::redis::error::not_splittable`.
+ *  @param key The key, ignored by commands whose arguments are all keys e.g. `MGET`.
+ *  @param range The arguments, must outlive the operation. Pairs
+ *  e.g. the elements of a `std::map` count as a single element.
+ *  The arguments of `HSET`, `MSET` and `ZADD` come in pairs, a flat
+ *  range of them must have an even number of elements, otherwise
+ *  the operation completes with `boost::redis::error::not_splittable`
+ *  without sending anything. The same happens if a range for `ZADD`
+ *  starts with one of its options `NX`, `XX`, `GT`, `LT`, `CH` or
+ *  `INCR`: options are not supported, the range may only contain
+ *  score-member pairs.
+ *  @param resp The response.
+ *  @param max_elements Maximum number of elements per part. Rounded
+ *  down to an even number (but at least two) for flat ranges of
+ *  pairs, so that a pair is never split across parts.
+ *  @param token Completion token.
+ *
+ *  The completion token must have the following signature
+ *
+ *  @code
+ *  void f(system::error_code, std::size_t);
+ *  @endcode
+ */
+template <
+   class Connection,
+   class Range,
+   class Response,
+   class CompletionToken = asio::default_completion_token_t<typename Connection::executor_type>
+>
+auto
+async_exec_split(
+   Connection& conn,
+   std::string_view cmd,
+   std::string_view key,
+   Range const& range,
+   Response& resp,
+   std::size_t max_elements = 1000,
+   CompletionToken&& token = CompletionToken{})
+{
+   using namespace boost::redis::adapter;
+   using std::cbegin;
+   using std::cend;
+   using iterator_type = decltype(cbegin(range));
+   using value_type = std::decay_t<decltype(*cbegin(range))>;
+   using adapter_type = decltype(boost_redis_adapt(resp));
+   using merger_type = detail::split_merger<adapter_type>;
+   using op_type = detail::exec_split_op<Connection, iterator_type, merger_type>;
+
+   using detail::command_flags;
+   auto policy =
+      detail::get_command_flags(cmd) &
+      (command_flags::split_sum | command_flags::split_last | command_flags::split_concat | command_flags::split_ok);
+
+   auto const total = static_cast<std::size_t>(std::distance(cbegin(range), cend(range)));
+   auto const unit = detail::get_split_unit(cmd, resp3::bulk_counter<value_type>::size);
+
+   // An incomplete group would make a part fail after others have
+   // been applied.
+   if (total % unit != 0 || detail::starts_with_option(cmd, cbegin(range), cend(range)))
+      policy = command_flags::none;
+
+   auto st =
+      std::make_unique<typename op_type::state>(
+         cmd, key, cbegin(range), cend(range), max_elements, unit,
+         merger_type{boost_redis_adapt(resp), policy, total});
+
+   return asio::async_compose
+      < CompletionToken
+      , void(system::error_code, std::size_t)
+      >(op_type{&conn, std::move(st), policy}, token, conn);
+}
+
+} // boost::redis
+
+#endif // BOOST_REDIS_SPLITTER_HPP
@@ -11,6 +11,7 @@
 #include <boost/redis/impl/connection.ipp>
 #include <boost/redis/impl/response.ipp>
 #include <boost/redis/impl/runner.ipp>
+#include <boost/redis/impl/sha1.ipp>
 #include <boost/redis/resp3/impl/type.ipp>
 #include <boost/redis/resp3/impl/parser.ipp>
 #include <boost/redis/resp3/impl/serialization.ipp>
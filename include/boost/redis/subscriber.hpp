@@ -0,0 +1,220 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SUBSCRIBER_HPP
+#define BOOST_REDIS_SUBSCRIBER_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/ignore.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/detail/helper.hpp>
+#include <boost/redis/detail/push_dispatcher.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+template <class Subscriber>
+struct subscriber_run_op {
+   Subscriber* sub_ = nullptr;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro_) for (;;)
+      {
+         // Messages are dispatched while they are parsed, only the
+         // notifications are left to be consumed.
+         BOOST_ASIO_CORO_YIELD
+         sub_->conn_->async_receive(std::move(self));
+
+         // The receive operation fails on every connection loss, the
+         // subscriptions are restored on reconnection.
+         if (ec && (sub_->stopped_ || is_cancelled(self) || !sub_->conn_->will_reconnect())) {
+            self.complete(ec);
+            return;
+         }
+      }
+   }
+};
+
+} // detail
+
+/** @brief Dispatches pubsub messages to per channel handlers.
+ *  @ingroup high-level-api
+ *
+ *  Messages are decoded while they are parsed and passed to the
+ *  handler registered for their channel (or pattern) without being
+ *  stored. Subscriptions are restored automatically after a
+ *  reconnection, in the first write on the new connection, before
+ *  any other request.
+ *
+ *  The subscriber sets the receive response and the setup hook of the
+ *  connection, see `boost::redis::basic_connection::set_setup_hook`.
+ *  It must outlive the connection's `async_run`.
+ *
+ *  Handlers are called from within the connection's read operation,
+ *  they must not block. The views they receive are only valid
+ *  during the call.
+ *
+ *  @tparam Connection `boost::redis::connection` or `boost::redis::basic_connection`.
+ */
+template <class Connection>
+class basic_subscriber {
+public:
+   /// Executor type.
+   using executor_type = typename Connection::executor_type;
+
+   /// Handler type, receives the channel and the message.
+   using handler_type = detail::push_dispatcher::handler_type;
+
+   /** @brief Constructor.
+    *
+    *  @param conn The connection, must outlive this object.
+    */
+   explicit basic_subscriber(Connection& conn)
+   : conn_{&conn}
+   {
+      conn.set_receive_response(dispatcher_);
+      conn.set_setup_hook([this](request& req) { push_subscriptions(req); });
+
+      // While not connected (or on connection loss) nothing has to be
+      // sent, the setup hook subscribes to everything on connection.
+      for (auto& req : reqs_) {
+         req.get_config().cancel_if_not_connected = true;
+         req.get_config().cancel_on_connection_lost = true;
+      }
+   }
+
+   /// Subscribes to a channel, replaces its handler if already subscribed.
+   void subscribe(std::string channel, handler_type h)
+   {
+      pending().push("SUBSCRIBE", channel);
+      dispatcher_.channels.insert_or_assign(std::move(channel), std::move(h));
+      write();
+   }
+
+   /// Subscribes to a pattern, replaces its handler if already subscribed.
+   void psubscribe(std::string pattern, handler_type h)
+   {
+      pending().push("PSUBSCRIBE", pattern);
+      dispatcher_.patterns.insert_or_assign(std::move(pattern), std::move(h));
+      write();
+   }
+
+   /// Unsubscribes from a channel.
+   void unsubscribe(std::string const& channel)
+   {
+      if (dispatcher_.channels.erase(channel) == 0)
+         return;
+
+      pending().push("UNSUBSCRIBE", channel);
+      write();
+   }
+
+   /// Unsubscribes from a pattern.
+   void punsubscribe(std::string const& pattern)
+   {
+      if (dispatcher_.patterns.erase(pattern) == 0)
+         return;
+
+      pending().push("PUNSUBSCRIBE", pattern);
+      write();
+   }
+
+   /** @brief Consumes the push notifications of the connection.
+    *
+    *  Must be running for messages to be dispatched. Continues across
+    *  reconnections until `cancel` is called, the operation is
+    *  cancelled or the connection won't reconnect anymore.
+    *
+    *  @param token Completion token.
+    *
+    *  The completion token must have the following signature
+    *
+    *  @code
+    *  void f(system::error_code);
+    *  @endcode
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_run(CompletionToken&& token = CompletionToken{})
+   {
+      stopped_ = false;
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::subscriber_run_op<basic_subscriber>{this}, token, *conn_);
+   }
+
+   /// Completes `async_run`.
+   void cancel()
+   {
+      stopped_ = true;
+      conn_->cancel(operation::receive);
+   }
+
+private:
+   template <class> friend struct detail::subscriber_run_op;
+
+   request& pending() noexcept
+      { return reqs_[!sending_index_]; }
+
+   // Writes the pending commands unless a write is in progress.
+   void write()
+   {
+      if (writing_ || pending().get_commands() == 0)
+         return;
+
+      writing_ = true;
+      sending_index_ = !sending_index_;
+      conn_->async_exec(reqs_[sending_index_], ignore, [this](system::error_code, std::size_t) {
+         reqs_[sending_index_].clear();
+         writing_ = false;
+         write();
+      });
+   }
+
+   // All subscriptions in one command per kind.
+   void push_subscriptions(request& req)
+   {
+      keys_.clear();
+      for (auto const& e : dispatcher_.channels)
+         keys_.push_back(e.first);
+      req.push_range("SUBSCRIBE", keys_);
+
+      keys_.clear();
+      for (auto const& e : dispatcher_.patterns)
+         keys_.push_back(e.first);
+      req.push_range("PSUBSCRIBE", keys_);
+   }
+
+   Connection* conn_;
+   detail::push_dispatcher dispatcher_;
+
+   // Double buffered requests, one is being written while commands
+   // are added to the other.
+   request reqs_[2];
+   bool sending_index_ = false;
+   bool writing_ = false;
+   bool stopped_ = false;
+   std::vector<std::string_view> keys_;
+};
+
+/// A subscriber that uses `boost::redis::connection`.
+using subscriber = basic_subscriber<connection>;
+
+} // boost::redis
+
+#endif // BOOST_REDIS_SUBSCRIBER_HPP
@@ -36,6 +36,39 @@ struct usage {
 
    /// Number of push-bytes received.
    std::size_t push_bytes_received = 0;
+
+   /// Number of requests sent.
+   std::size_t requests_sent = 0;
+
+   /// Number of writes to the socket, `requests_sent / writes` gives the average number of requests per write.
+   std::size_t writes = 0;
+
+   /// Number of requests currently in the queue, excluding `HELLO` and health-checks (gauge).
+   std::size_t requests_queued = 0;
+
+   /// Number of request bytes currently in the queue, excluding `HELLO` and health-checks (gauge).
+   std::size_t bytes_queued = 0;
+
+   /// Number of `async_exec` calls currently suspended because the queue is full (gauge).
+   std::size_t requests_suspended = 0;
+
+   /// Number of requests removed from the queue because their timeout expired, see `boost::redis::request::config::timeout`.
+   std::size_t requests_shed = 0;
+
+   /// Number of written requests whose `async_exec` was cancelled, their responses are discarded.
+   std::size_t requests_abandoned = 0;
+
+   /// Number of requests whose command was fused with others, see `boost::redis::config::read_fusion_max_requests`.
+   std::size_t requests_fused = 0;
+
+   /// Number of requests that received a copy of the responses to an identical request, see `boost::redis::config::single_flight`.
+   std::size_t requests_deduplicated = 0;
+
+   /// Number of pushes discarded or replaced by a newer one in the backlog, see `boost::redis::config::push_backlog`.
+   std::size_t pushes_dropped = 0;
+
+   /// Current pipeline depth limit, see `boost::redis::config::adaptive_pipeline` (gauge).
+   std::size_t pipeline_depth_limit = 0;
 };
 
 } // boost::redis
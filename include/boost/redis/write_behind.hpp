@@ -0,0 +1,276 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_WRITE_BEHIND_HPP
+#define BOOST_REDIS_WRITE_BEHIND_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/detail/helper.hpp>
+#include <boost/redis/detail/bulk_error_collector.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+template <class WriteBehind>
+struct write_behind_op {
+   WriteBehind* wb_ = nullptr;
+   asio::coroutine coro_{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro_) for (;;)
+      {
+         // A cancellation received during a flush would otherwise be
+         // seen only after a full flush interval.
+         if (is_cancelled(self)) {
+            self.get_cancellation_state().clear();
+            wb_->stopping_ = true;
+         }
+
+         if (!wb_->stopping_ && wb_->pending() < wb_->max_pending_) {
+            wb_->timer_.expires_after(wb_->interval_);
+
+            BOOST_ASIO_CORO_YIELD
+            wb_->timer_.async_wait(std::move(self));
+
+            if (is_cancelled(self)) {
+               self.get_cancellation_state().clear();
+               wb_->stopping_ = true;
+            }
+         }
+
+         if (wb_->pending() != 0) {
+            wb_->prepare_flush();
+
+            // Not cancellable so that pending writes are flushed on
+            // shutdown.
+            BOOST_ASIO_CORO_YIELD
+            wb_->conn_->async_exec(
+               wb_->req_,
+               wb_->collector_,
+               asio::bind_cancellation_slot(asio::cancellation_slot{}, std::move(self)));
+
+            if (ec) {
+               self.complete(ec);
+               return;
+            }
+         }
+
+         if (wb_->stopping_ && wb_->pending() == 0) {
+            self.complete({});
+            return;
+         }
+      }
+   }
+};
+
+} // detail
+
+/** @brief Combines writes to the same keys before sending them.
+ *  @ingroup high-level-api
+ *
+ *  Writes are accumulated in memory and flushed in a single pipelined
+ *  request once per flush interval: `INCRBY` and `HINCRBY` deltas are
+ *  added per key (and field) and only the last `SET` to a key is kept.
+ *  A `SET` discards the deltas accumulated before it for the same key,
+ *  and is sent before the deltas that follow it, so the result is the
+ *  same as if each write had been sent individually.
+ *
+ *  Writes are at most about one flush interval old when they are
+ *  sent. A flush is also started as soon as the number of pending
+ *  keys reaches the configured maximum, which bounds memory usage.
+ *
+ *  The object must outlive `async_run`.
+ *
+ *  @tparam Connection `boost::redis::connection` or `boost::redis::basic_connection`.
+ */
+template <class Connection>
+class basic_write_behind {
+public:
+   /// Executor type.
+   using executor_type = typename Connection::executor_type;
+
+   /// An error response and the index of the command in its flush.
+   using error_type = std::pair<std::size_t, std::string>;
+
+   /** @brief Constructor.
+    *
+    *  @param conn The connection, must outlive this object.
+    *  @param flush_interval Time between flushes.
+    *  @param max_pending Number of pending keys that triggers a flush.
+    */
+   explicit
+   basic_write_behind(
+      Connection& conn,
+      std::chrono::steady_clock::duration flush_interval = std::chrono::milliseconds{100},
+      std::size_t max_pending = 10000)
+   : conn_{&conn}
+   , timer_{conn.get_executor()}
+   , interval_{flush_interval}
+   , max_pending_{(std::max)(max_pending, std::size_t{1})}
+   {
+      // Background writes should not delay interactive requests. If
+      // the connection is lost they are not retried once written, as
+      // increments are not idempotent.
+      req_.get_config().priority = request_priority::batch;
+      req_.get_config().cancel_on_connection_lost = false;
+      req_.get_config().cancel_if_unresponded = true;
+      collector_.errors = &errors_;
+   }
+
+   /// Adds `delta` to the integer stored at `key`, see `INCRBY`.
+   void incrby(std::string_view key, std::int64_t delta)
+   {
+      incr_[std::string{key}] += delta;
+      on_write();
+   }
+
+   /// Adds `delta` to the integer stored at `field` in the hash at `key`, see `HINCRBY`.
+   void hincrby(std::string_view key, std::string_view field, std::int64_t delta)
+   {
+      auto& fields = hincr_[std::string{key}];
+      auto const [iter, inserted] = fields.try_emplace(std::string{field}, delta);
+      if (inserted)
+         ++hincr_fields_;
+      else
+         iter->second += delta;
+
+      on_write();
+   }
+
+   /// Sets `key` to `value`, see `SET`.
+   void set(std::string_view key, std::string_view value)
+   {
+      std::string k{key};
+      incr_.erase(k);
+      if (auto const iter = hincr_.find(k); iter != std::end(hincr_)) {
+         hincr_fields_ -= std::size(iter->second);
+         hincr_.erase(iter);
+      }
+
+      set_.insert_or_assign(std::move(k), std::string{value});
+      on_write();
+   }
+
+   /// Returns the number of pending keys (and hash fields).
+   [[nodiscard]] auto pending() const noexcept
+      { return std::size(set_) + std::size(incr_) + hincr_fields_; }
+
+   /** @brief Flushes pending writes periodically.
+    *
+    *  Runs until `cancel` is called or the operation is cancelled,
+    *  after which the pending writes are flushed before completing.
+    *  Error responses don't complete the operation, see `get_errors`.
+    *
+    *  @param token Completion token.
+    *
+    *  The completion token must have the following signature
+    *
+    *  @code
+    *  void f(system::error_code);
+    *  @endcode
+    *
+    *  It completes with an error if a flush fails, in which case its
+    *  writes may or may not have been applied.
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_run(CompletionToken&& token = CompletionToken{})
+   {
+      stopping_ = false;
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::write_behind_op<basic_write_behind>{this}, token, timer_);
+   }
+
+   /// Flushes the pending writes and completes `async_run`.
+   void cancel()
+   {
+      stopping_ = true;
+      timer_.cancel();
+   }
+
+   /// Returns the errors of the last flush.
+   auto const& get_errors() const noexcept
+      { return errors_; }
+
+private:
+   template <class> friend struct detail::write_behind_op;
+
+   using timer_type =
+      asio::basic_waitable_timer<
+         std::chrono::steady_clock,
+         asio::wait_traits<std::chrono::steady_clock>,
+         executor_type>;
+
+   void on_write()
+   {
+      if (pending() >= max_pending_)
+         timer_.cancel();
+   }
+
+   // Moves the pending writes into the request.
+   void prepare_flush()
+   {
+      req_.clear();
+      errors_.clear();
+
+      for (auto const& [key, value] : set_)
+         req_.push("SET", key, value);
+
+      for (auto const& [key, delta] : incr_)
+         req_.push("INCRBY", key, delta);
+
+      for (auto const& [key, fields] : hincr_) {
+         for (auto const& [field, delta] : fields)
+            req_.push("HINCRBY", key, field, delta);
+      }
+
+      set_.clear();
+      incr_.clear();
+      hincr_.clear();
+      hincr_fields_ = 0;
+   }
+
+   Connection* conn_;
+   timer_type timer_;
+   std::chrono::steady_clock::duration interval_;
+   std::size_t max_pending_;
+   bool stopping_ = false;
+
+   std::unordered_map<std::string, std::string> set_;
+   std::unordered_map<std::string, std::int64_t> incr_;
+   std::unordered_map<std::string, std::unordered_map<std::string, std::int64_t>> hincr_;
+   std::size_t hincr_fields_ = 0;
+
+   request req_;
+   detail::bulk_error_collector collector_;
+   std::vector<error_type> errors_;
+};
+
+/// A write-behind accumulator that uses `boost::redis::connection`.
+using write_behind = basic_write_behind<connection>;
+
+} // boost::redis
+
+#endif // BOOST_REDIS_WRITE_BEHIND_HPP
@@ -48,6 +48,11 @@ std::string get_server_hostname()
    return safe_getenv("BOOST_REDIS_TEST_SERVER", "localhost");
 }
 
+std::string get_sentinel_hostname()
+{
+   return safe_getenv("BOOST_REDIS_TEST_SENTINEL", "localhost");
+}
+
 boost::redis::config make_test_config()
 {
    boost::redis::config cfg;
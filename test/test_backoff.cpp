@@ -0,0 +1,66 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/backoff.hpp>
+#define BOOST_TEST_MODULE backoff
+#include <boost/test/included/unit_test.hpp>
+
+using boost::redis::config;
+using boost::redis::detail::backoff;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(exponential_without_jitter)
+{
+   config cfg;
+   cfg.reconnect_wait_interval = 1s;
+   cfg.reconnect_max_wait_interval = 5s;
+   cfg.reconnect_backoff_factor = 2.0;
+   cfg.reconnect_jitter = 0.0;
+
+   backoff b;
+   b.set_config(cfg);
+
+   BOOST_TEST((b.next_wait(false) == 1s));
+   BOOST_TEST((b.next_wait(false) == 2s));
+   BOOST_TEST((b.next_wait(false) == 4s));
+   BOOST_TEST((b.next_wait(false) == 5s));
+   BOOST_TEST((b.next_wait(false) == 5s));
+   BOOST_CHECK_EQUAL(b.get_attempts(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(healthy_connection_resets)
+{
+   config cfg;
+   cfg.reconnect_first_wait_interval = 10ms;
+   cfg.reconnect_wait_interval = 1s;
+   cfg.reconnect_jitter = 0.0;
+
+   backoff b;
+   b.set_config(cfg);
+
+   b.next_wait(false);
+   b.next_wait(false);
+   BOOST_TEST((b.next_wait(true) == 10ms));
+   BOOST_CHECK_EQUAL(b.get_attempts(), 0u);
+   BOOST_TEST((b.next_wait(false) == 1s));
+}
+
+BOOST_AUTO_TEST_CASE(jitter_bounds)
+{
+   config cfg;
+   cfg.reconnect_wait_interval = 1s;
+   cfg.reconnect_backoff_factor = 1.0;
+   cfg.reconnect_jitter = 0.5;
+
+   backoff b;
+   b.set_config(cfg);
+
+   for (int i = 0; i < 100; ++i) {
+      auto const w = b.next_wait(false);
+      BOOST_TEST((w <= 1s));
+      BOOST_TEST((w >= 500ms));
+   }
+}
@@ -0,0 +1,47 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/concurrency_limiter.hpp>
+#define BOOST_TEST_MODULE concurrency_limiter
+#include <boost/test/included/unit_test.hpp>
+
+#include <limits>
+
+using boost::redis::config;
+using boost::redis::detail::concurrency_limiter;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(disabled_is_unlimited)
+{
+   concurrency_limiter l;
+   l.set_config(config{});
+   l.reset();
+   l.on_response(1ms);
+   BOOST_CHECK_EQUAL(l.get_limit(), (std::numeric_limits<std::size_t>::max)());
+}
+
+BOOST_AUTO_TEST_CASE(grows_and_shrinks)
+{
+   config cfg;
+   cfg.adaptive_pipeline = true;
+   cfg.min_pipeline_depth = 2;
+   cfg.max_pipeline_depth = 16;
+
+   concurrency_limiter l;
+   l.set_config(cfg);
+   l.reset();
+   BOOST_CHECK_EQUAL(l.get_limit(), 2u);
+
+   // Low latency makes the limit grow up to the maximum.
+   for (int i = 0; i < 500; ++i)
+      l.on_response(200us);
+   BOOST_CHECK_EQUAL(l.get_limit(), 16u);
+
+   // High latency makes it shrink down to the minimum.
+   for (int i = 0; i < 500; ++i)
+      l.on_response(10ms);
+   BOOST_CHECK_EQUAL(l.get_limit(), 2u);
+}
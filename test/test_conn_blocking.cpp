@@ -0,0 +1,63 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#define BOOST_TEST_MODULE conn-blocking
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+namespace net = boost::asio;
+using connection = boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore;
+using error_code = boost::system::error_code;
+
+// A BLPOP that never completes must not hold back the requests
+// written after it when blocking connections are enabled.
+BOOST_AUTO_TEST_CASE(blocking_runs_on_side_connection)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   auto cfg = make_test_config();
+   cfg.blocking_connections = 1;
+   run(conn, cfg);
+
+   request req1;
+   req1.push("BLPOP", "test-conn-blocking-never-pushed", 0);
+   BOOST_TEST(req1.is_blocking());
+
+   request req2;
+   req2.push("PING", "req2");
+
+   bool finished1 = false;
+   bool finished2 = false;
+   error_code ec1;
+
+   conn->async_exec(req1, ignore, [&](auto ec, auto) {
+      ec1 = ec;
+      finished1 = true;
+   });
+
+   response<std::string> resp2;
+   conn->async_exec(req2, resp2, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      BOOST_TEST(!finished1);
+      finished2 = true;
+
+      // Must also cancel the BLPOP pending on the side connection,
+      // otherwise ioc.run() doesn't return.
+      conn->cancel();
+   });
+
+   ioc.run();
+
+   BOOST_TEST(finished1);
+   BOOST_TEST(finished2);
+   BOOST_TEST(!!ec1);
+   BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), "req2");
+}
@@ -0,0 +1,98 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/bulk_loader.hpp>
+#include <boost/redis/connection.hpp>
+#define BOOST_TEST_MODULE conn-bulk-loader
+#include <boost/test/included/unit_test.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include "common.hpp"
+
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::bulk_loader;
+using boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+
+BOOST_AUTO_TEST_CASE(error_index)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   // Small chunks and window so that the load takes many round trips.
+   bulk_loader loader{*conn, 256, 2};
+
+   std::size_t constexpr total = 1000;
+   std::size_t constexpr failing = 437;
+   std::size_t i = 0;
+   auto gen = [&](request& req) {
+      if (i == 0)
+         req.push("SET", "bulk-loader-str", "abc");
+      else if (i == failing)
+         req.push("INCR", "bulk-loader-str");
+      else
+         req.push("SET", "bulk-loader:" + std::to_string(i), i);
+
+      return ++i < total;
+   };
+
+   request get;
+   get.push("GET", "bulk-loader:999");
+   response<std::string> resp;
+
+   loader.async_load(gen, [&](auto ec, auto n) {
+      BOOST_TEST(!ec);
+      BOOST_CHECK_EQUAL(n, total);
+      conn->async_exec(get, resp, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(i, total);
+   BOOST_REQUIRE_EQUAL(std::size(loader.get_errors()), 1u);
+   BOOST_CHECK_EQUAL(loader.get_errors().front().first, failing);
+   BOOST_TEST(!loader.get_errors().front().second.empty());
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "999");
+}
+
+BOOST_AUTO_TEST_CASE(cancel)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+   bulk_loader loader{*conn, 256, 2};
+
+   // Never exhausted, the load only completes on cancellation.
+   net::cancellation_signal sig;
+   std::size_t generated = 0;
+   auto gen = [&](request& req) {
+      req.push("INCR", "bulk-loader-counter");
+      if (++generated == 5000)
+         net::post(ioc, [&]() { sig.emit(net::cancellation_type::terminal); });
+
+      return true;
+   };
+
+   bool finished = false;
+   loader.async_load(gen, net::bind_cancellation_slot(sig.slot(), [&](auto ec, auto n) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+      BOOST_TEST(n < generated);
+      BOOST_TEST(loader.get_errors().empty());
+      finished = true;
+      conn->cancel();
+   }));
+
+   run(conn);
+   ioc.run();
+
+   BOOST_TEST(finished);
+}
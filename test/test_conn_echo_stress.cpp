@@ -36,7 +36,9 @@ std::ostream& operator<<(std::ostream& os, usage const& u)
       << "Responses received: " << u.responses_received << "\n"
       << "Pushes received: " << u.pushes_received << "\n"
       << "Response bytes received: " << u.response_bytes_received << "\n"
-      << "Push bytes received: " << u.push_bytes_received;
+      << "Push bytes received: " << u.push_bytes_received << "\n"
+      << "Requests sent: " << u.requests_sent << "\n"
+      << "Writes: " << u.writes;
 
    return os;
 }
@@ -9,7 +9,9 @@
 #include <boost/asio/detached.hpp>
 #define BOOST_TEST_MODULE conn-exec
 #include <boost/test/included/unit_test.hpp>
+#include <functional>
 #include <iostream>
+#include <string>
 #include "common.hpp"
 
 // TODO: Test whether HELLO won't be inserted passt commands that have
@@ -188,3 +190,152 @@ BOOST_AUTO_TEST_CASE(large_number_of_concurrent_requests_issue_170)
    BOOST_CHECK_EQUAL(counter, repeat);
 }
 
+BOOST_AUTO_TEST_CASE(progressive_responses)
+{
+   request req;
+   req.push("PING", "0");
+   req.push("PING", "1");
+   req.push("PING", "2");
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   std::vector<std::string> seen;
+   auto cb = [&](std::size_t i, generic_response const& resp)
+   {
+      BOOST_TEST(resp.has_value());
+      BOOST_CHECK_EQUAL(resp.value().size(), 1u);
+      BOOST_CHECK_EQUAL(resp.value().front().value, std::to_string(i));
+      seen.push_back(resp.value().front().value);
+   };
+
+   conn->async_exec_progressive(req, cb, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(seen.size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(progressive_responses_error)
+{
+   request req;
+   req.push("PING", "0");
+   req.push("PROGRESSIVE-UNKNOWN-COMMAND");
+   req.push("PING", "2");
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   // The buffer is reset after the error, the next response is a value.
+   std::size_t calls = 0;
+   auto cb = [&](std::size_t i, generic_response const& resp)
+   {
+      ++calls;
+      if (i == 1) {
+         BOOST_TEST(!resp.has_value());
+         BOOST_TEST(!resp.error().diagnostic.empty());
+         return;
+      }
+
+      BOOST_TEST(resp.has_value());
+      BOOST_CHECK_EQUAL(resp.value().size(), 1u);
+      BOOST_CHECK_EQUAL(resp.value().front().value, std::to_string(i));
+   };
+
+   conn->async_exec_progressive(req, cb, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(calls, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(single_flight)
+{
+   auto cfg = make_test_config();
+   cfg.single_flight = true;
+
+   request req1;
+   req1.push("ECHO", "shared");
+
+   request req2;
+   req2.push("ECHO", "shared");
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   response<std::string> resp1;
+   response<std::string> resp2;
+   int completed = 0;
+   auto f = [&](auto ec, auto)
+   {
+      BOOST_TEST(!ec);
+      if (++completed == 2)
+         conn->cancel();
+   };
+
+   // The second request is identical, it receives a copy of the
+   // response to the first one instead of being written.
+   conn->async_exec(req1, resp1, f);
+   conn->async_exec(req2, resp2, f);
+
+   run(conn, cfg);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(completed, 2);
+   BOOST_CHECK_EQUAL(std::get<0>(resp1).value(), "shared");
+   BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), "shared");
+   BOOST_CHECK_EQUAL(conn->get_usage().requests_deduplicated, 1u);
+}
+
+// Each exec is started from the completion of the previous one so
+// that it reuses its request info, whose state must not leak into
+// the next exec.
+BOOST_AUTO_TEST_CASE(sequential_requests)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   int const repeat = 100;
+   int counter = 0;
+   request req;
+   response<std::string> resp;
+
+   std::function<void()> exec_next = [&]()
+   {
+      // Every fourth request fails.
+      req.clear();
+      if (counter % 4 == 3)
+         req.push("SEQUENTIAL-UNKNOWN-COMMAND");
+      else
+         req.push("ECHO", std::to_string(counter));
+
+      resp = {};
+      conn->async_exec(req, resp, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         if (counter % 4 == 3)
+            BOOST_TEST(std::get<0>(resp).has_error());
+         else
+            BOOST_CHECK_EQUAL(std::get<0>(resp).value(), std::to_string(counter));
+
+         if (++counter == repeat)
+            conn->cancel();
+         else
+            exec_next();
+      });
+   };
+
+   exec_next();
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(counter, repeat);
+}
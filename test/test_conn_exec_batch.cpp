@@ -0,0 +1,59 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#define BOOST_TEST_MODULE conn-exec-batch
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <array>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::connection;
+using boost::redis::operation;
+using boost::redis::request;
+using boost::redis::response;
+using error_code = boost::system::error_code;
+
+BOOST_AUTO_TEST_CASE(batch_completes_once)
+{
+   std::array<request, 3> reqs;
+   reqs[0].push("PING", "a");
+   reqs[1].push("PING", "b");
+   reqs[2].push("PING", "c");
+
+   std::array<request const*, 3> req_ptrs{&reqs[0], &reqs[1], &reqs[2]};
+   std::array<response<std::string>, 3> resps;
+   std::array<response<std::string>*, 3> resp_ptrs{&resps[0], &resps[1], &resps[2]};
+   std::array<error_code, 3> results;
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   int calls = 0;
+   conn->async_exec_batch(
+      boost::span<request const* const>{req_ptrs},
+      boost::span<response<std::string>* const>{resp_ptrs},
+      boost::span<error_code>{results},
+      [&](auto ec, auto n) {
+         ++calls;
+         BOOST_TEST(!ec);
+         BOOST_TEST(n != 0u);
+         conn->cancel();
+      });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(calls, 1);
+   for (auto const& ec : results)
+      BOOST_TEST(!ec);
+
+   BOOST_CHECK_EQUAL(std::get<0>(resps[0]).value(), "a");
+   BOOST_CHECK_EQUAL(std::get<0>(resps[1]).value(), "b");
+   BOOST_CHECK_EQUAL(std::get<0>(resps[2]).value(), "c");
+}
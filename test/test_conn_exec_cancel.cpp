@@ -62,12 +62,19 @@ auto implicit_cancel_of_req_written() -> net::awaitable<void>
       st.async_wait(redir(ec2))
    );
 
-   conn->cancel();
-
    // I have observed this produces terminal cancellation so it can't
    // be ignored, an error is expected.
    BOOST_CHECK_EQUAL(ec1, net::error::operation_aborted);
    BOOST_TEST(!ec2);
+
+   // The connection is still usable, the response to BLPOP is
+   // discarded when it arrives.
+   response<std::string> resp;
+   co_await conn->async_exec(req0, resp, net::use_awaitable);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "PONG");
+   BOOST_CHECK_EQUAL(conn->get_usage().requests_abandoned, 1u);
+
+   conn->cancel();
 }
 
 BOOST_AUTO_TEST_CASE(test_ignore_implicit_cancel_of_req_written)
@@ -0,0 +1,225 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#define BOOST_TEST_MODULE conn-exec-queue-limit
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <array>
+#include <string>
+
+namespace net = boost::asio;
+using connection = boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore;
+using boost::redis::error;
+using boost::redis::operation;
+using boost::redis::queue_full_action;
+using boost::redis::generic_response;
+using error_code = boost::system::error_code;
+
+BOOST_AUTO_TEST_CASE(queue_full_fails)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   auto cfg = make_test_config();
+   cfg.max_queued_requests = 1;
+   cfg.on_queue_full = queue_full_action::fail;
+   run(conn, cfg);
+
+   request req1;
+   req1.push("PING", "req1");
+
+   request req2;
+   req2.push("PING", "req2");
+
+   bool finished1 = false;
+   bool finished2 = false;
+
+   conn->async_exec(req1, ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      BOOST_TEST(finished2);
+      finished1 = true;
+      conn->cancel();
+   });
+
+   conn->async_exec(req2, ignore, [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, error::queue_full);
+      finished2 = true;
+   });
+
+   ioc.run();
+
+   BOOST_TEST(finished1);
+   BOOST_TEST(finished2);
+}
+
+BOOST_AUTO_TEST_CASE(queue_full_suspends)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   auto cfg = make_test_config();
+   cfg.max_queued_requests = 1;
+   cfg.on_queue_full = queue_full_action::suspend;
+   run(conn, cfg);
+
+   request req1;
+   req1.push("PING", "req1");
+
+   request req2;
+   req2.push("PING", "req2");
+
+   response<std::string> resp1;
+   response<std::string> resp2;
+
+   bool finished1 = false;
+   bool finished2 = false;
+
+   conn->async_exec(req1, resp1, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      BOOST_TEST(!finished2);
+      finished1 = true;
+   });
+
+   conn->async_exec(req2, resp2, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      BOOST_TEST(finished1);
+      finished2 = true;
+      BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), "req2");
+      conn->cancel();
+   });
+
+   auto const u = conn->get_usage();
+   BOOST_CHECK_EQUAL(u.requests_queued, 1u);
+   BOOST_CHECK_EQUAL(u.requests_suspended, 1u);
+
+   ioc.run();
+
+   BOOST_TEST(finished1);
+   BOOST_TEST(finished2);
+   BOOST_CHECK_EQUAL(std::get<0>(resp1).value(), "req1");
+}
+
+// A suspended request that is cancelled must wake up the ones waiting
+// behind it, here the queue is empty by then.
+BOOST_AUTO_TEST_CASE(cancel_suspended)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   auto cfg = make_test_config();
+   cfg.max_queued_requests = 1;
+   cfg.on_queue_full = queue_full_action::suspend;
+   cfg.health_check_interval = std::chrono::seconds::zero();
+   run(conn, cfg);
+
+   request req1;
+   req1.get_config().cancel_if_not_connected = false;
+   req1.push("PING", "req1");
+
+   request req2;
+   req2.get_config().cancel_if_not_connected = false;
+   req2.push("PING", "req2");
+
+   request req3;
+   req3.get_config().cancel_if_not_connected = false;
+   req3.push("PING", "req3");
+
+   net::cancellation_signal sig1;
+   net::cancellation_signal sig2;
+   response<std::string> resp3;
+   bool finished3 = false;
+
+   conn->async_exec(req1, ignore, net::bind_cancellation_slot(sig1.slot(), [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+
+      // req2 is still suspended, req3 has to wait behind it.
+      conn->async_exec(req3, resp3, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         finished3 = true;
+         conn->cancel();
+      });
+
+      BOOST_CHECK_EQUAL(conn->get_usage().requests_suspended, 2u);
+   }));
+
+   conn->async_exec(req2, ignore, net::bind_cancellation_slot(sig2.slot(), [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+
+      // req3 is admitted without waiting for any response.
+      net::post(ioc, [&]() {
+         auto const u = conn->get_usage();
+         BOOST_CHECK_EQUAL(u.requests_suspended, 0u);
+         BOOST_CHECK_EQUAL(u.requests_queued, 1u);
+      });
+   }));
+
+   BOOST_CHECK_EQUAL(conn->get_usage().requests_suspended, 1u);
+
+   // req1 leaves the queue first, then req2 stops waiting.
+   sig1.emit(net::cancellation_type::terminal);
+   sig2.emit(net::cancellation_type::terminal);
+
+   ioc.run();
+
+   BOOST_TEST(finished3);
+   BOOST_CHECK_EQUAL(std::get<0>(resp3).value(), "req3");
+}
+
+// A batch is admitted as a whole only if all its requests fit.
+BOOST_AUTO_TEST_CASE(batch_counts_all_requests)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   auto cfg = make_test_config();
+   cfg.max_queued_requests = 2;
+   cfg.on_queue_full = queue_full_action::fail;
+   run(conn, cfg);
+
+   request req;
+   req.push("PING", "req");
+
+   request b1;
+   b1.push("PING", "b1");
+   request b2;
+   b2.push("PING", "b2");
+
+   std::array<request const*, 2> reqs{&b1, &b2};
+   std::array<generic_response, 2> resps;
+   std::array<generic_response*, 2> resp_ptrs{&resps[0], &resps[1]};
+   std::array<error_code, 2> results;
+
+   bool finished = false;
+   conn->async_exec(req, ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      BOOST_TEST(finished);
+      conn->cancel();
+   });
+
+   // One request is queued, the batch of two would exceed the limit.
+   conn->async_exec_batch(
+      boost::span<request const* const>{reqs},
+      boost::span<generic_response* const>{resp_ptrs},
+      boost::span<error_code>{results},
+      [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         BOOST_CHECK_EQUAL(results[0], error::queue_full);
+         BOOST_CHECK_EQUAL(results[1], error::queue_full);
+         finished = true;
+      });
+
+   ioc.run();
+
+   BOOST_TEST(finished);
+}
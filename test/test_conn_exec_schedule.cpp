@@ -0,0 +1,342 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#define BOOST_TEST_MODULE conn-exec-schedule
+#include <boost/test/included/unit_test.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace net = boost::asio;
+using boost::redis::config;
+using boost::redis::connection;
+using boost::redis::ignore;
+using boost::redis::operation;
+using boost::redis::request;
+using boost::redis::request_priority;
+using error_code = boost::system::error_code;
+
+namespace
+{
+
+request make_request(std::string const& name, request_priority priority, std::size_t producer = 0)
+{
+   request req;
+   req.get_config().cancel_if_not_connected = false;
+   req.get_config().priority = priority;
+   req.get_config().producer = producer;
+   req.push("PING", name);
+   return req;
+}
+
+// Executes the request and records its name once it is cancelled.
+void exec_cancelled(connection& conn, request const& req, std::string name, std::vector<std::string>& order)
+{
+   conn.async_exec(req, ignore, [&order, name = std::move(name)](error_code ec, std::size_t) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+      order.push_back(name);
+   });
+}
+
+// Plays the server, no Redis server is needed. Every command is
+// recorded and, if reply is true, answered with +OK.
+class fake_server {
+public:
+   explicit fake_server(net::io_context& ioc)
+   : acceptor_{ioc, {net::ip::make_address("127.0.0.1"), 0}}
+   , socket_{ioc}
+   {
+      acceptor_.async_accept(socket_, [this](error_code ec) {
+         if (!ec)
+            read();
+      });
+   }
+
+   auto make_config() const
+   {
+      config cfg;
+      cfg.addr.host = "127.0.0.1";
+      cfg.addr.port = std::to_string(acceptor_.local_endpoint().port());
+      cfg.health_check_interval = std::chrono::seconds::zero();
+      cfg.reconnect_wait_interval = std::chrono::seconds::zero();
+      return cfg;
+   }
+
+   // Called after each read, the connection is closed if it returns false.
+   std::function<bool(std::vector<std::string> const&)> on_read = [](auto const&) { return true; };
+   bool reply = true;
+   std::vector<std::string> commands;
+
+private:
+   void read()
+   {
+      socket_.async_read_some(net::buffer(buffer_), [this](error_code ec, std::size_t n) {
+         if (ec)
+            return;
+
+         data_.append(buffer_.data(), n);
+         std::string out;
+         while (parse_command()) {
+            if (reply)
+               out += "+OK\r\n";
+         }
+
+         if (!on_read(commands)) {
+            socket_.close();
+            return;
+         }
+
+         reply_ = std::move(out);
+         net::async_write(socket_, net::buffer(reply_), [this](error_code ec, std::size_t) {
+            if (!ec)
+               read();
+         });
+      });
+   }
+
+   // Removes a command from data_, its arguments are joined by spaces.
+   bool parse_command()
+   {
+      std::size_t pos = 0;
+      auto next_line = [&]() -> std::optional<std::string> {
+         auto const end = data_.find("\r\n", pos);
+         if (end == std::string::npos)
+            return std::nullopt;
+
+         auto line = data_.substr(pos, end - pos);
+         pos = end + 2;
+         return line;
+      };
+
+      auto const header = next_line();
+      if (!header)
+         return false;
+
+      std::string cmd;
+      auto const args = std::stoul(header->substr(1));
+      for (std::size_t i = 0; i < args; ++i) {
+         auto const size = next_line();
+         if (!size)
+            return false;
+
+         auto const len = std::stoul(size->substr(1));
+         if (std::size(data_) < pos + len + 2)
+            return false;
+
+         if (i != 0)
+            cmd += ' ';
+         cmd.append(data_, pos, len);
+         pos += len + 2;
+      }
+
+      data_.erase(0, pos);
+      commands.push_back(std::move(cmd));
+      return true;
+   }
+
+   net::ip::tcp::acceptor acceptor_;
+   net::ip::tcp::socket socket_;
+   std::array<char, 4096> buffer_;
+   std::string data_;
+   std::string reply_;
+};
+
+} // namespace
+
+// No async_run is called, requests are cancelled in queue order.
+BOOST_AUTO_TEST_CASE(priority_classes)
+{
+   net::io_context ioc;
+   connection conn{ioc};
+
+   auto const b1 = make_request("b1", request_priority::batch);
+   auto const i1 = make_request("i1", request_priority::interactive);
+   auto const b2 = make_request("b2", request_priority::batch);
+   auto const i2 = make_request("i2", request_priority::interactive);
+
+   std::vector<std::string> order;
+   exec_cancelled(conn, b1, "b1", order);
+   exec_cancelled(conn, i1, "i1", order);
+   exec_cancelled(conn, b2, "b2", order);
+   exec_cancelled(conn, i2, "i2", order);
+
+   net::post(ioc, [&]() { conn.cancel(operation::exec); });
+   ioc.run();
+
+   std::vector<std::string> const expected{"i1", "i2", "b1", "b2"};
+   BOOST_TEST(order == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(producer_round_robin)
+{
+   net::io_context ioc;
+   connection conn{ioc};
+
+   auto const a1 = make_request("a1", request_priority::interactive, 1);
+   auto const a2 = make_request("a2", request_priority::interactive, 1);
+   auto const a3 = make_request("a3", request_priority::interactive, 1);
+   auto const b1 = make_request("b1", request_priority::interactive, 2);
+   auto const b2 = make_request("b2", request_priority::interactive, 2);
+
+   std::vector<std::string> order;
+   exec_cancelled(conn, a1, "a1", order);
+   exec_cancelled(conn, a2, "a2", order);
+   exec_cancelled(conn, a3, "a3", order);
+   exec_cancelled(conn, b1, "b1", order);
+   exec_cancelled(conn, b2, "b2", order);
+
+   net::post(ioc, [&]() { conn.cancel(operation::exec); });
+   ioc.run();
+
+   std::vector<std::string> const expected{"a1", "b1", "a2", "b2", "a3"};
+   BOOST_TEST(order == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(batch_max_bytes_per_write)
+{
+   auto writes_for = [](std::size_t batch_max) {
+      net::io_context ioc;
+      fake_server server{ioc};
+      auto cfg = server.make_config();
+      cfg.batch_max_bytes_per_write = batch_max;
+
+      connection conn{ioc};
+
+      // Requests of about 100 bytes queued before connecting.
+      std::vector<request> reqs;
+      for (char c = '1'; c <= '3'; ++c)
+         reqs.push_back(make_request(std::string(100, c), request_priority::batch));
+
+      std::size_t done = 0;
+      for (auto const& req : reqs) {
+         conn.async_exec(req, ignore, [&](error_code ec, std::size_t) {
+            BOOST_TEST(!ec);
+            if (++done == std::size(reqs))
+               conn.cancel();
+         });
+      }
+
+      conn.async_run(cfg, {}, [](error_code) {});
+      ioc.run();
+
+      BOOST_CHECK_EQUAL(done, std::size(reqs));
+      BOOST_CHECK_EQUAL(conn.get_usage().commands_sent, 4u);
+      return conn.get_usage().writes;
+   };
+
+   // A single batch request per write, HELLO may share the first.
+   BOOST_TEST(writes_for(150) >= 3u);
+   BOOST_TEST(writes_for(64 * 1024) <= 2u);
+}
+
+// A batch request is written before an interactive one, after the
+// connection is lost both are waiting again and must be retried
+// in priority order.
+BOOST_AUTO_TEST_CASE(written_requests_reordered_on_connection_lost)
+{
+   net::io_context ioc;
+   fake_server server{ioc};
+   server.reply = false;
+
+   connection conn{ioc};
+
+   auto keep = [](request req) {
+      req.get_config().cancel_on_connection_lost = false;
+      req.get_config().cancel_if_unresponded = false;
+      return req;
+   };
+
+   auto const b1 = keep(make_request("b1", request_priority::batch));
+   auto const i1 = keep(make_request("i1", request_priority::interactive));
+   std::vector<std::string> order;
+
+   bool interactive_sent = false;
+   server.on_read = [&](std::vector<std::string> const& cmds) {
+      auto const has = [&](std::string const& cmd) {
+         return std::find(std::cbegin(cmds), std::cend(cmds), cmd) != std::cend(cmds);
+      };
+
+      if (has("PING b1") && !std::exchange(interactive_sent, true))
+         exec_cancelled(conn, i1, "i1", order);
+
+      // Closes once both have been written.
+      return !has("PING i1");
+   };
+
+   exec_cancelled(conn, b1, "b1", order);
+
+   // Not reconnecting, the requests kept in the queue are cancelled
+   // once async_run completes.
+   conn.async_run(server.make_config(), {}, [&](error_code ec) {
+      BOOST_TEST(!!ec);
+      conn.cancel(operation::exec);
+   });
+
+   ioc.run();
+
+   std::vector<std::string> const expected{"i1", "b1"};
+   BOOST_TEST(order == expected, boost::test_tools::per_element());
+}
+
+// Requests arriving while a response is pending share a write.
+BOOST_AUTO_TEST_CASE(write_coalescing)
+{
+   net::io_context ioc;
+   fake_server server{ioc};
+   server.reply = false;
+
+   auto cfg = server.make_config();
+   cfg.write_coalesce_interval = std::chrono::milliseconds{50};
+
+   connection conn{ioc};
+
+   auto const r0 = make_request("r0", request_priority::interactive);
+   auto const r1 = make_request("r1", request_priority::interactive);
+   auto const r2 = make_request("r2", request_priority::interactive);
+
+   boost::redis::usage before;
+   boost::redis::usage after;
+   bool sent = false;
+   server.on_read = [&](std::vector<std::string> const& cmds) {
+      if (std::empty(cmds))
+         return true;
+
+      if (cmds.back() == "PING r0" && !std::exchange(sent, true)) {
+         // r0 is waiting for a response, r1 and r2 are sent
+         // separately within the window.
+         before = conn.get_usage();
+         conn.async_exec(r1, ignore, [](error_code, std::size_t) {});
+         net::post(ioc, [&]() { conn.async_exec(r2, ignore, [](error_code, std::size_t) {}); });
+      }
+
+      if (cmds.back() != "PING r2")
+         return true;
+
+      after = conn.get_usage();
+      return false;
+   };
+
+   conn.async_exec(r0, ignore, [](error_code, std::size_t) {});
+   conn.async_run(cfg, {}, [](error_code) {});
+   ioc.run();
+
+   BOOST_REQUIRE(std::size(server.commands) >= 3u);
+   std::vector<std::string> const expected{"PING r0", "PING r1", "PING r2"};
+   std::vector<std::string> const last{std::prev(std::cend(server.commands), 3), std::cend(server.commands)};
+   BOOST_TEST(last == expected, boost::test_tools::per_element());
+
+   BOOST_CHECK_EQUAL(after.writes - before.writes, 1u);
+   BOOST_CHECK_EQUAL(after.commands_sent - before.commands_sent, 2u);
+   BOOST_CHECK_EQUAL(after.bytes_sent - before.bytes_sent, std::size(r1.payload()) + std::size(r2.payload()));
+}
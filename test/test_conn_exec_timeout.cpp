@@ -0,0 +1,56 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#define BOOST_TEST_MODULE conn-exec-timeout
+#include <boost/test/included/unit_test.hpp>
+
+namespace net = boost::asio;
+using connection = boost::redis::connection;
+using boost::redis::request;
+using boost::redis::ignore;
+using boost::redis::error;
+using namespace std::chrono_literals;
+
+// No async_run is called, requests wait in the queue until their
+// timeout expires.
+BOOST_AUTO_TEST_CASE(waiting_request_is_shed)
+{
+   net::io_context ioc;
+   connection conn{ioc};
+
+   request req1;
+   req1.get_config().cancel_if_not_connected = false;
+   req1.get_config().timeout = 10ms;
+   req1.push("PING");
+
+   request req2;
+   req2.get_config().cancel_if_not_connected = false;
+   req2.get_config().timeout = 50ms;
+   req2.push("PING");
+
+   bool finished1 = false;
+   bool finished2 = false;
+
+   conn.async_exec(req2, ignore, [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, error::request_timeout);
+      BOOST_TEST(finished1);
+      finished2 = true;
+   });
+
+   conn.async_exec(req1, ignore, [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, error::request_timeout);
+      BOOST_TEST(!finished2);
+      finished1 = true;
+   });
+
+   ioc.run();
+
+   BOOST_TEST(finished1);
+   BOOST_TEST(finished2);
+   BOOST_CHECK_EQUAL(conn.get_usage().requests_shed, 2u);
+   BOOST_CHECK_EQUAL(conn.get_usage().requests_queued, 0u);
+}
@@ -127,6 +127,45 @@ BOOST_AUTO_TEST_CASE(push_received1)
    BOOST_TEST(push_async_received);
 }
 
+BOOST_AUTO_TEST_CASE(push_backlog_conflate)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   // The publishes are responded although no push is received
+   // meanwhile, the messages are conflated into the last one.
+   request req;
+   req.push("SUBSCRIBE", "backlog-channel");
+   req.push("PUBLISH", "backlog-channel", "1");
+   req.push("PUBLISH", "backlog-channel", "2");
+   req.push("PUBLISH", "backlog-channel", "3");
+
+   redis::generic_response resp;
+   conn->set_receive_response(resp);
+
+   conn->async_exec(req, ignore, [conn, &resp](auto ec, auto){
+      BOOST_TEST(!ec);
+
+      // The subscribe confirmation.
+      conn->async_receive([conn, &resp](auto ec, auto){
+         BOOST_TEST(!ec);
+         resp.value().clear();
+
+         conn->async_receive([conn, &resp](auto ec, auto){
+            BOOST_TEST(!ec);
+            BOOST_CHECK_EQUAL(resp.value().back().value, "3");
+            BOOST_CHECK_EQUAL(conn->get_usage().pushes_dropped, 2u);
+            conn->cancel();
+         });
+      });
+   });
+
+   auto cfg = make_test_config();
+   cfg.push_backlog = redis::push_backlog_policy::conflate;
+   run(conn, cfg);
+   ioc.run();
+}
+
 BOOST_AUTO_TEST_CASE(push_filtered_out)
 {
    net::io_context ioc;
@@ -0,0 +1,103 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#define BOOST_TEST_MODULE conn-read-fusion
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <array>
+#include <optional>
+#include <string>
+
+namespace net = boost::asio;
+using connection = boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore;
+using error_code = boost::system::error_code;
+
+using get_response = response<std::optional<std::string>>;
+
+BOOST_AUTO_TEST_CASE(get_and_hget)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   auto cfg = make_test_config();
+   cfg.read_fusion_max_requests = 16;
+
+   request setup;
+   setup.push("DEL", "fusion-a", "fusion-b", "fusion-missing", "fusion-list", "fusion-hash");
+   setup.push("SET", "fusion-a", "a");
+   setup.push("SET", "fusion-b", "b");
+   setup.push("RPUSH", "fusion-list", "x");
+   setup.push("HSET", "fusion-hash", "f1", "v1", "f2", "v2");
+
+   auto make_request = [](auto const&... args)
+   {
+      request req;
+      req.push(args...);
+      return req;
+   };
+
+   // Written together since they are all issued before the connection
+   // is established. The SET is not fusible and separates the GETs in
+   // two groups, the GET after it must see the new value.
+   std::array<request, 9> reqs{
+      make_request("GET", "fusion-a"),
+      make_request("GET", "fusion-missing"),
+      make_request("GET", "fusion-list"),
+      make_request("GET", "fusion-b"),
+      make_request("SET", "fusion-b", "b2"),
+      make_request("GET", "fusion-b"),
+      make_request("HGET", "fusion-hash", "f1"),
+      make_request("HGET", "fusion-hash", "missing"),
+      make_request("HGET", "fusion-hash", "f2"),
+   };
+
+   std::array<get_response, 9> resps;
+   std::size_t completed = 0;
+
+   conn->async_exec(setup, ignore, [](auto ec, auto) {
+      BOOST_TEST(!ec);
+   });
+
+   for (std::size_t i = 0; i < std::size(reqs); ++i) {
+      conn->async_exec(reqs[i], resps[i], [&, i](auto ec, auto) {
+         BOOST_TEST(!ec);
+
+         // Responses arrive in order.
+         BOOST_CHECK_EQUAL(completed, i);
+         if (++completed == std::size(reqs))
+            conn->cancel();
+      });
+   }
+
+   run(conn, cfg);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(completed, std::size(reqs));
+
+   auto const value = [&](std::size_t i) { return std::get<0>(resps.at(i)).value(); };
+   BOOST_CHECK_EQUAL(value(0).value(), "a");
+   BOOST_TEST(!value(1).has_value());
+
+   // A key that doesn't hold a string gives null instead of an error
+   // when fused, see config::read_fusion_max_requests.
+   BOOST_TEST(!value(2).has_value());
+
+   BOOST_CHECK_EQUAL(value(3).value(), "b");
+   BOOST_CHECK_EQUAL(value(4).value(), "OK");
+   BOOST_CHECK_EQUAL(value(5).value(), "b2");
+   BOOST_CHECK_EQUAL(value(6).value(), "v1");
+   BOOST_TEST(!value(7).has_value());
+   BOOST_CHECK_EQUAL(value(8).value(), "v2");
+
+   // The four GETs before the SET and the three HGETs, the GET after
+   // the SET is alone in its group.
+   BOOST_TEST(conn->get_usage().requests_fused >= 7u);
+}
@@ -0,0 +1,220 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/replicated_connection.hpp>
+#define BOOST_TEST_MODULE conn-replicated
+#include <boost/test/included/unit_test.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include "common.hpp"
+
+#include <string>
+
+#ifdef BOOST_ASIO_HAS_CO_AWAIT
+
+namespace net = boost::asio;
+using boost::redis::config;
+using boost::redis::ignore;
+using boost::redis::replica_selection;
+using boost::redis::replicated_connection;
+using boost::redis::request;
+using boost::redis::response;
+using error_code = boost::system::error_code;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// The test server plays the primary and both replicas, reads don't
+// depend on the role.
+auto make_replicated_config() -> config
+{
+   auto cfg = make_test_config();
+   cfg.replicas.addresses = {cfg.addr, cfg.addr};
+   return cfg;
+}
+
+void start_run(replicated_connection& conn, config const& cfg)
+{
+   conn.async_run(cfg, {}, [](error_code ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+}
+
+auto wait_replicas(replicated_connection& conn) -> net::awaitable<void>
+{
+   net::steady_timer st{co_await net::this_coro::executor};
+   while (!conn.replica(0).is_ready() || !conn.replica(1).is_ready()) {
+      st.expires_after(10ms);
+      co_await st.async_wait(net::use_awaitable);
+   }
+}
+
+request make_read()
+{
+   request req;
+   req.push("GET", "replicated-key");
+   return req;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(selection)
+{
+   net::io_context ioc;
+   replicated_connection conn{ioc};
+
+   request write;
+   write.push("SET", "replicated-key", "value");
+
+   auto read = make_read();
+   auto primary_read = make_read();
+   primary_read.get_config().read_from_primary = true;
+
+   auto cfg = make_replicated_config();
+   cfg.replicas.selection = replica_selection::fewest_outstanding;
+   start_run(conn, cfg);
+
+   // No replica is connected yet.
+   BOOST_CHECK_EQUAL(&conn.select(read), &conn.primary());
+
+   net::co_spawn(ioc, [&]() -> net::awaitable<void> {
+      co_await wait_replicas(conn);
+
+      // Replicas use the ssl context of the primary.
+      BOOST_CHECK_EQUAL(&conn.replica(0).get_ssl_context(), &conn.primary().get_ssl_context());
+      BOOST_CHECK_EQUAL(&conn.replica(1).get_ssl_context(), &conn.primary().get_ssl_context());
+
+      BOOST_CHECK_EQUAL(&conn.select(write), &conn.primary());
+      BOOST_CHECK_EQUAL(&conn.select(primary_read), &conn.primary());
+
+      // Fewest outstanding: a busy replica is not selected.
+      auto& first = conn.select(read);
+      BOOST_TEST(&first != &conn.primary());
+      first.async_exec(read, ignore, [](auto, auto) {});
+      auto& second = conn.select(read);
+      BOOST_TEST(&second != &conn.primary());
+      BOOST_TEST(&second != &first);
+
+      co_await conn.async_exec(write, ignore, net::use_awaitable);
+
+      response<std::string> resp;
+      co_await conn.async_exec(read, resp, net::use_awaitable);
+      BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "value");
+
+      conn.cancel();
+   }, net::detached);
+
+   ioc.run();
+}
+
+BOOST_AUTO_TEST_CASE(hedged)
+{
+   net::io_context ioc;
+   replicated_connection conn{ioc};
+
+   // Duplicates every read right away.
+   auto cfg = make_replicated_config();
+   cfg.replicas.hedge_min_samples = 0;
+   cfg.replicas.hedge_min_delay = 0s;
+   start_run(conn, cfg);
+
+   net::co_spawn(ioc, [&]() -> net::awaitable<void> {
+      co_await wait_replicas(conn);
+
+      request write;
+      write.push("SET", "replicated-key", "value");
+      co_await conn.async_exec(write, ignore, net::use_awaitable);
+
+      auto const read = make_read();
+      for (int i = 0; i < 10; ++i) {
+         response<std::string> resp;
+         co_await conn.async_exec_hedged(read, resp, net::use_awaitable);
+         BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "value");
+      }
+
+      BOOST_TEST(conn.get_hedged_requests() != 0u);
+      BOOST_TEST(conn.get_hedges_won() <= conn.get_hedged_requests());
+
+      conn.cancel();
+   }, net::detached);
+
+   ioc.run();
+}
+
+BOOST_AUTO_TEST_CASE(hedged_needs_samples)
+{
+   net::io_context ioc;
+   replicated_connection conn{ioc};
+
+   auto cfg = make_replicated_config();
+   cfg.replicas.hedge_min_samples = 1000000;
+   cfg.replicas.hedge_min_delay = 0s;
+   start_run(conn, cfg);
+
+   net::co_spawn(ioc, [&]() -> net::awaitable<void> {
+      co_await wait_replicas(conn);
+
+      auto const read = make_read();
+      for (int i = 0; i < 10; ++i)
+         co_await conn.async_exec_hedged(read, ignore, net::use_awaitable);
+
+      BOOST_CHECK_EQUAL(conn.get_hedged_requests(), 0u);
+      BOOST_CHECK_EQUAL(conn.get_hedges_won(), 0u);
+
+      conn.cancel();
+   }, net::detached);
+
+   ioc.run();
+}
+
+BOOST_AUTO_TEST_CASE(hedged_cancel)
+{
+   net::io_context ioc;
+   replicated_connection conn{ioc};
+
+   auto cfg = make_replicated_config();
+   cfg.replicas.hedge_min_samples = 0;
+   cfg.replicas.hedge_min_delay = 1h;
+   start_run(conn, cfg);
+
+   net::co_spawn(ioc, [&]() -> net::awaitable<void> {
+      co_await wait_replicas(conn);
+
+      // Cancelled while waiting for the hedge delay, the exec that
+      // was started is cancelled as well.
+      auto const read = make_read();
+      net::cancellation_signal sig;
+      bool finished = false;
+      conn.async_exec_hedged(read, ignore, net::bind_cancellation_slot(sig.slot(), [&](error_code ec, std::size_t) {
+         BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+         finished = true;
+      }));
+      sig.emit(net::cancellation_type::terminal);
+
+      // The connections are still usable.
+      response<std::string> resp;
+      request ping;
+      ping.push("PING");
+      co_await conn.async_exec(ping, resp, net::use_awaitable);
+      BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "PONG");
+      BOOST_TEST(finished);
+      BOOST_CHECK_EQUAL(conn.get_hedged_requests(), 0u);
+
+      conn.cancel();
+   }, net::detached);
+
+   ioc.run();
+}
+
+#else
+BOOST_AUTO_TEST_CASE(dummy)
+{
+   BOOST_TEST(true);
+}
+#endif
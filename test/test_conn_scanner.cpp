@@ -0,0 +1,134 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/scanner.hpp>
+#define BOOST_TEST_MODULE conn-scanner
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <functional>
+#include <set>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::connection;
+using boost::redis::ignore;
+using boost::redis::request;
+using boost::redis::scanner;
+
+namespace
+{
+
+// Twenty strings and twenty hashes under their own prefixes.
+request make_key_set(std::set<std::string>& strings, std::set<std::string>& hashes)
+{
+   request req;
+   for (int i = 0; i < 20; ++i) {
+      auto const str = "scanner-test:str:" + std::to_string(i);
+      auto const hash = "scanner-test:hash:" + std::to_string(i);
+      req.push("SET", str, i);
+      req.push("HSET", hash, "field", i);
+      strings.insert(str);
+      hashes.insert(hash);
+   }
+
+   return req;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(two_partitions)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   std::set<std::string> strings;
+   std::set<std::string> hashes;
+   auto const setup = make_key_set(strings, hashes);
+
+   // A small count so that each partition takes several pages.
+   scanner s{conn->get_executor(), "SCAN", {}, 5};
+   s.add_partition(*conn, "scanner-test:str:*", "string");
+   s.add_partition(*conn, "scanner-test:hash:*", "hash");
+
+   std::set<std::string> found_strings;
+   std::set<std::string> found_hashes;
+   std::size_t pages = 0;
+
+   std::function<void()> next = [&]() {
+      if (s.is_done()) {
+         conn->cancel();
+         return;
+      }
+
+      s.async_next([&](auto ec, auto n) {
+         BOOST_TEST(!ec);
+         BOOST_CHECK_EQUAL(n, std::size(s.get_keys()));
+         ++pages;
+
+         // SCAN may return a key more than once.
+         for (auto const& key : s.get_keys()) {
+            if (key.rfind("scanner-test:str:", 0) == 0)
+               found_strings.insert(key);
+            else
+               found_hashes.insert(key);
+         }
+
+         next();
+      });
+   };
+
+   conn->async_exec(setup, ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      next();
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_TEST(s.is_done());
+   BOOST_TEST(pages > 2u);
+   BOOST_TEST(found_strings == strings);
+   BOOST_TEST(found_hashes == hashes);
+}
+
+BOOST_AUTO_TEST_CASE(cancel)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   std::set<std::string> strings;
+   std::set<std::string> hashes;
+   auto const setup = make_key_set(strings, hashes);
+
+   scanner s{conn->get_executor(), "SCAN", {}, 1};
+   s.add_partition(*conn, "scanner-test:*");
+
+   bool finished = false;
+   conn->async_exec(setup, ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      s.async_next([&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         BOOST_TEST(!s.is_done());
+
+         // Cancels the prefetch of the next page.
+         s.cancel();
+         s.async_next([&](auto ec, auto n) {
+            BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+            BOOST_CHECK_EQUAL(n, 0u);
+            finished = true;
+            conn->cancel();
+         });
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_TEST(finished);
+   BOOST_TEST(s.is_done());
+}
@@ -0,0 +1,118 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/script.hpp>
+#define BOOST_TEST_MODULE conn-script
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace net = boost::asio;
+using boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::script;
+using boost::redis::script_registry;
+
+BOOST_AUTO_TEST_CASE(noscript_is_recovered)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   // Removes the script from the cache of the server.
+   request flush;
+   flush.push("SCRIPT", "FLUSH");
+   conn->async_exec(flush, boost::redis::ignore, [](auto, auto) {});
+
+   script const s{"return ARGV[1] .. KEYS[1]"};
+   std::array<std::string, 1> keys{"b"};
+   std::array<std::string, 1> args{"a"};
+   response<std::string> resp1;
+   response<std::string> resp2;
+
+   boost::redis::async_evalsha(*conn, s, keys, args, resp1, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+
+      // Loaded by the previous call.
+      boost::redis::async_evalsha(*conn, s, keys, args, resp2, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_TEST(std::get<0>(resp1).has_value());
+   BOOST_CHECK_EQUAL(std::get<0>(resp1).value(), "ab");
+   BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), "ab");
+}
+
+BOOST_AUTO_TEST_CASE(load_error)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   // Never in the cache, since it doesn't compile.
+   script const s{"return ("};
+   std::array<std::string, 0> keys;
+   std::array<std::string, 0> args;
+   response<std::string> resp;
+
+   boost::redis::async_evalsha(*conn, s, keys, args, resp, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   run(conn);
+   ioc.run();
+
+   // The compile error, not NOSCRIPT.
+   BOOST_TEST(!std::get<0>(resp).has_value());
+   BOOST_TEST(std::get<0>(resp).error().diagnostic.rfind("NOSCRIPT", 0) != 0u);
+}
+
+BOOST_AUTO_TEST_CASE(preload)
+{
+   net::io_context ioc;
+   auto flusher = std::make_shared<connection>(ioc);
+   auto conn = std::make_shared<connection>(ioc);
+
+   script_registry reg;
+   auto const& s = reg.add("return 'preloaded'");
+   auto cfg = make_test_config();
+   reg.preload(cfg);
+
+   request flush;
+   flush.push("SCRIPT", "FLUSH");
+
+   request exists;
+   exists.push("SCRIPT", "EXISTS", s.sha1());
+   response<std::vector<int>> resp;
+
+   // The cache is flushed before conn connects, the script must have
+   // been loaded by its setup.
+   flusher->async_exec(flush, boost::redis::ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      flusher->cancel();
+
+      run(conn, cfg);
+      conn->async_exec(exists, resp, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(flusher);
+   ioc.run();
+
+   std::vector<int> const expected{1};
+   BOOST_TEST(std::get<0>(resp).value() == expected, boost::test_tools::per_element());
+}
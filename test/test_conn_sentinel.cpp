@@ -0,0 +1,229 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/asio/detached.hpp>
+#define BOOST_TEST_MODULE conn-sentinel
+#include <boost/test/included/unit_test.hpp>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include "common.hpp"
+
+// Needs the sentinel setup of tools/docker-compose.yml: a sentinel
+// monitoring the master mymaster, that has one replica.
+
+#ifdef BOOST_ASIO_HAS_CO_AWAIT
+
+namespace net = boost::asio;
+using boost::system::error_code;
+using boost::redis::address;
+using boost::redis::config;
+using boost::redis::connection;
+using boost::redis::generic_response;
+using boost::redis::request;
+using boost::redis::response;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+auto make_sentinel_test_config(std::string master_name = "mymaster") -> config
+{
+   config cfg;
+   cfg.sentinel.addresses = {address{get_sentinel_hostname(), "26379"}};
+   cfg.sentinel.master_name = std::move(master_name);
+   return cfg;
+}
+
+// Returns the value of field in the reply of INFO.
+auto get_info_field(std::string_view info, std::string_view field) -> std::string
+{
+   auto pos = info.find(field);
+   if (pos == std::string_view::npos)
+      return {};
+
+   info.remove_prefix(pos + std::size(field) + 1);
+   return std::string{info.substr(0, info.find_first_of("\r\n"))};
+}
+
+struct server_info {
+   std::string role;
+   std::string run_id;
+};
+
+// Role and run id of the server conn is connected to, empty if the
+// request fails e.g. because the connection is down.
+auto get_server_info(connection& conn) -> net::awaitable<server_info>
+{
+   request req;
+   req.get_config().cancel_if_not_connected = true;
+   req.push("ROLE");
+   req.push("INFO", "server");
+
+   generic_response resp;
+   error_code ec;
+   co_await conn.async_exec(req, resp, redir(ec));
+   if (ec || !resp.has_value() || std::size(resp.value()) < 2)
+      co_return server_info{};
+
+   // The first element of the ROLE reply is the role and the INFO
+   // reply is the last node.
+   auto const& nodes = resp.value();
+   co_return server_info{nodes.at(1).value, get_info_field(nodes.back().value, "run_id")};
+}
+
+auto wait_for(std::chrono::steady_clock::duration d) -> net::awaitable<void>
+{
+   net::steady_timer timer{co_await net::this_coro::executor, d};
+   co_await timer.async_wait(net::use_awaitable);
+}
+
+net::awaitable<void> test_resolve_impl()
+{
+   auto conn = std::make_shared<connection>(co_await net::this_coro::executor);
+   run(conn, make_sentinel_test_config());
+
+   server_info info;
+   for (int i = 0; i < 50 && info.role.empty(); ++i) {
+      info = co_await get_server_info(*conn);
+      if (info.role.empty())
+         co_await wait_for(100ms);
+   }
+
+   conn->cancel();
+   BOOST_CHECK_EQUAL(info.role, "master");
+   BOOST_TEST(!info.run_id.empty());
+}
+
+net::awaitable<void> test_failover_impl()
+{
+   auto ex = co_await net::this_coro::executor;
+
+   auto conn = std::make_shared<connection>(ex);
+   run(conn, make_sentinel_test_config());
+
+   server_info old_master;
+   for (int i = 0; i < 50 && old_master.role.empty(); ++i) {
+      old_master = co_await get_server_info(*conn);
+      if (old_master.role.empty())
+         co_await wait_for(100ms);
+   }
+   BOOST_CHECK_EQUAL(old_master.role, "master");
+
+   // Plain connection to the sentinel to trigger the failover.
+   auto sentinel = std::make_shared<connection>(ex);
+   auto sentinel_cfg = make_test_config();
+   sentinel_cfg.addr = address{get_sentinel_hostname(), "26379"};
+   run(sentinel, sentinel_cfg);
+
+   request failover;
+   failover.push("SENTINEL", "FAILOVER", "mymaster");
+
+   // A previous failover may still be in progress (-INPROG) or the
+   // replica may not have synced yet (-NOGOODSLAVE).
+   bool triggered = false;
+   for (int i = 0; i < 30 && !triggered; ++i) {
+      response<std::string> resp;
+      error_code ec;
+      co_await sentinel->async_exec(failover, resp, redir(ec));
+      triggered = !ec && std::get<0>(resp).has_value();
+      if (!triggered)
+         co_await wait_for(1s);
+   }
+   BOOST_TEST(triggered);
+
+   // The connection must reconnect to the new master once the
+   // sentinel announces +switch-master.
+   server_info new_master;
+   for (int i = 0; i < 300; ++i) {
+      new_master = co_await get_server_info(*conn);
+      if (new_master.role == "master" && new_master.run_id != old_master.run_id)
+         break;
+      co_await wait_for(100ms);
+   }
+
+   conn->cancel();
+   sentinel->cancel();
+
+   BOOST_CHECK_EQUAL(new_master.role, "master");
+   BOOST_TEST(new_master.run_id != old_master.run_id);
+}
+
+// Number of connections the sentinel has received so far.
+auto get_sentinel_connections(connection& sentinel) -> net::awaitable<long>
+{
+   request req;
+   req.push("INFO", "stats");
+
+   response<std::string> resp;
+   co_await sentinel.async_exec(req, resp, net::use_awaitable);
+   co_return std::stol(get_info_field(std::get<0>(resp).value(), "total_connections_received"));
+}
+
+net::awaitable<void> test_resolve_backoff_impl()
+{
+   auto ex = co_await net::this_coro::executor;
+
+   auto sentinel = std::make_shared<connection>(ex);
+   auto sentinel_cfg = make_test_config();
+   sentinel_cfg.addr = address{get_sentinel_hostname(), "26379"};
+   run(sentinel, sentinel_cfg);
+   auto const before = co_await get_sentinel_connections(*sentinel);
+
+   // The sentinel doesn't know this master, every resolve fails and
+   // opens a new connection to the sentinel. With the waits below
+   // attempts happen at roughly 0, 200, 600 and 1400ms, whereas
+   // without backoff there would be more than ten of them.
+   auto cfg = make_sentinel_test_config("unknown-master");
+   cfg.reconnect_wait_interval = 200ms;
+   cfg.reconnect_first_wait_interval = 200ms;
+   cfg.reconnect_backoff_factor = 2.0;
+   cfg.reconnect_jitter = 0.0;
+
+   auto conn = std::make_shared<connection>(ex);
+   run(conn, cfg);
+
+   co_await wait_for(2500ms);
+   conn->cancel();
+
+   auto const after = co_await get_sentinel_connections(*sentinel);
+   sentinel->cancel();
+
+   auto const attempts = after - before;
+   BOOST_TEST(attempts >= 2);
+   BOOST_TEST(attempts <= 6);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(resolve)
+{
+   net::io_context ioc;
+   net::co_spawn(ioc, test_resolve_impl(), net::detached);
+   ioc.run();
+}
+
+BOOST_AUTO_TEST_CASE(reconnect_after_switch_master)
+{
+   net::io_context ioc;
+   net::co_spawn(ioc, test_failover_impl(), net::detached);
+   ioc.run();
+}
+
+BOOST_AUTO_TEST_CASE(resolve_failure_backoff)
+{
+   net::io_context ioc;
+   net::co_spawn(ioc, test_resolve_backoff_impl(), net::detached);
+   ioc.run();
+}
+
+#else
+BOOST_AUTO_TEST_CASE(dummy)
+{
+   BOOST_TEST(true);
+}
+#endif
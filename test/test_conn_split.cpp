@@ -0,0 +1,172 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/splitter.hpp>
+#define BOOST_TEST_MODULE conn-split
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace net = boost::asio;
+using boost::redis::async_exec_split;
+using boost::redis::connection;
+using boost::redis::error;
+using boost::redis::ignore;
+using boost::redis::request;
+using boost::redis::response;
+
+BOOST_AUTO_TEST_CASE(flat_pairs)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request del;
+   del.push("DEL", "split-hash");
+   conn->async_exec(del, ignore, [](auto, auto) {});
+
+   // Seven field-value pairs in a flat range, three elements per part
+   // would split pairs, it is rounded down to two.
+   std::vector<std::string> args;
+   for (int i = 0; i < 7; ++i) {
+      args.push_back("field" + std::to_string(i));
+      args.push_back("value" + std::to_string(i));
+   }
+
+   response<std::size_t> resp;
+   request hlen;
+   hlen.push("HLEN", "split-hash");
+   response<std::size_t> len;
+
+   async_exec_split(*conn, "HSET", "split-hash", args, resp, 3, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      conn->async_exec(hlen, len, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), 7u);
+   BOOST_CHECK_EQUAL(std::get<0>(len).value(), 7u);
+   BOOST_CHECK_EQUAL(conn->get_usage().commands_sent >= 7u, true);
+}
+
+BOOST_AUTO_TEST_CASE(concat)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   std::map<std::string, std::string> kv;
+   for (int i = 0; i < 5; ++i)
+      kv["split-key" + std::to_string(i)] = std::to_string(i);
+
+   std::vector<std::string> keys;
+   for (auto const& e : kv)
+      keys.push_back(e.first);
+
+   response<std::string> ok;
+   response<std::vector<std::string>> resp;
+
+   // Pairs of a map count as a single element.
+   async_exec_split(*conn, "MSET", "", kv, ok, 2, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      async_exec_split(*conn, "MGET", "", keys, resp, 2, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(ok).value(), "OK");
+   std::vector<std::string> const expected{"0", "1", "2", "3", "4"};
+   BOOST_TEST(std::get<0>(resp).value() == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(incomplete_pair)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request del;
+   del.push("DEL", "split-odd1", "split-odd2");
+   conn->async_exec(del, ignore, [](auto, auto) {});
+
+   std::vector<std::string> const args{"split-odd1", "1", "split-odd2"};
+   request exists;
+   exists.push("EXISTS", "split-odd1", "split-odd2");
+   response<std::size_t> count;
+
+   async_exec_split(*conn, "MSET", "", args, ignore, 2, [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, error::not_splittable);
+
+      // Nothing has been sent.
+      conn->async_exec(exists, count, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(count).value(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(zadd_options)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request del;
+   del.push("DEL", "split-zadd-options");
+   conn->async_exec(del, ignore, [](auto, auto) {});
+
+   // CH has an even number of arguments after it and would otherwise
+   // be sent as a score-member pair.
+   std::vector<std::string> const args{"NX", "CH", "1", "a", "2", "b"};
+   request exists;
+   exists.push("EXISTS", "split-zadd-options");
+   response<std::size_t> count;
+
+   async_exec_split(*conn, "ZADD", "split-zadd-options", args, ignore, 2, [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, error::not_splittable);
+
+      // Nothing has been sent.
+      conn->async_exec(exists, count, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(count).value(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(not_splittable)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   std::vector<std::string> const args{"a"};
+   bool finished = false;
+   async_exec_split(*conn, "GET", "key", args, ignore, 2, [&](auto ec, auto) {
+      BOOST_CHECK_EQUAL(ec, error::not_splittable);
+      finished = true;
+   });
+
+   ioc.run();
+   BOOST_TEST(finished);
+}
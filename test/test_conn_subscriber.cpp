@@ -0,0 +1,129 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/subscriber.hpp>
+#define BOOST_TEST_MODULE conn-subscriber
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <functional>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::subscriber;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(dispatch_per_channel)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+   subscriber sub{*conn};
+
+   std::string received;
+   int others = 0;
+
+   // Subscribed by the setup hook, in the same write as HELLO.
+   sub.subscribe("subscriber-channel", [&](std::string_view channel, std::string_view msg) {
+      BOOST_CHECK_EQUAL(channel, "subscriber-channel");
+      received = msg;
+      sub.cancel();
+      conn->cancel();
+   });
+
+   sub.subscribe("subscriber-other", [&](auto, auto) { ++others; });
+   sub.unsubscribe("subscriber-other");
+
+   request req;
+   req.push("PUBLISH", "subscriber-other", "ignored");
+   req.push("PUBLISH", "subscriber-channel", "hello");
+   conn->async_exec(req, boost::redis::ignore, [](auto, auto) {});
+
+   sub.async_run([](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(received, "hello");
+   BOOST_CHECK_EQUAL(others, 0);
+}
+
+BOOST_AUTO_TEST_CASE(resubscribe_after_reconnect)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+   auto publisher = std::make_shared<connection>(ioc);
+   subscriber sub{*conn};
+   net::steady_timer timer{ioc};
+
+   request publish;
+   publish.push("PUBLISH", "subscriber-reconnect", "after");
+
+   // Messages published before the subscription has been restored
+   // are lost, so publishes until one arrives.
+   int publishes = 0;
+   std::function<void()> publish_after = [&]()
+   {
+      publisher->async_exec(publish, boost::redis::ignore, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         if (++publishes == 50) {
+            // Gives up, the check below fails.
+            sub.cancel();
+            conn->cancel();
+            publisher->cancel();
+            return;
+         }
+
+         timer.expires_after(100ms);
+         timer.async_wait([&](auto ec) {
+            if (!ec)
+               publish_after();
+         });
+      });
+   };
+
+   request kill;
+   kill.push("CLIENT", "KILL", "TYPE", "pubsub");
+   response<int> killed;
+
+   std::string received;
+   sub.subscribe("subscriber-reconnect", [&](std::string_view, std::string_view msg) {
+      if (msg == "before") {
+         // Kills the connection of the subscriber from another one.
+         publisher->async_exec(kill, killed, [&](auto ec, auto) {
+            BOOST_TEST(!ec);
+            publish_after();
+         });
+         return;
+      }
+
+      received = msg;
+      timer.cancel();
+      sub.cancel();
+      conn->cancel();
+      publisher->cancel();
+   });
+
+   request req;
+   req.push("PUBLISH", "subscriber-reconnect", "before");
+   conn->async_exec(req, boost::redis::ignore, [](auto, auto) {});
+
+   sub.async_run([](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+
+   run(conn);
+   run(publisher);
+   ioc.run();
+
+   BOOST_TEST(std::get<0>(killed).value() >= 1);
+   BOOST_CHECK_EQUAL(received, "after");
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/write_behind.hpp>
+#define BOOST_TEST_MODULE conn-write-behind
+#include <boost/test/included/unit_test.hpp>
+#include "common.hpp"
+
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::write_behind;
+
+BOOST_AUTO_TEST_CASE(flush_on_cancel)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request del;
+   del.push("DEL", "write-behind-counter", "write-behind-status");
+   conn->async_exec(del, boost::redis::ignore, [](auto, auto) {});
+
+   // The interval is long so that everything is flushed on cancel.
+   write_behind wb{*conn, std::chrono::hours{1}};
+   wb.set("write-behind-counter", "10");
+   wb.incrby("write-behind-counter", 1);
+   wb.incrby("write-behind-counter", 2);
+   wb.set("write-behind-status", "a");
+   wb.set("write-behind-status", "b");
+   BOOST_CHECK_EQUAL(wb.pending(), 3u);
+
+   request get;
+   get.push("GET", "write-behind-counter");
+   get.push("GET", "write-behind-status");
+   response<std::string, std::string> resp;
+
+   wb.async_run([&](auto ec) {
+      BOOST_TEST(!ec);
+      BOOST_TEST(wb.get_errors().empty());
+      conn->async_exec(get, resp, [&](auto ec, auto) {
+         BOOST_TEST(!ec);
+         conn->cancel();
+      });
+   });
+
+   wb.cancel();
+
+   run(conn);
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(wb.pending(), 0u);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "13");
+   BOOST_CHECK_EQUAL(std::get<1>(resp).value(), "b");
+}
+
+BOOST_AUTO_TEST_CASE(cancel_during_flush)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   // A single pending key triggers a flush, the interval is long so
+   // that the test hangs if the cancellation is seen only after it.
+   write_behind wb{*conn, std::chrono::hours{1}, 1};
+   net::cancellation_signal sig;
+   bool finished = false;
+
+   wb.async_run(net::bind_cancellation_slot(sig.slot(), [&](auto ec) {
+      BOOST_TEST(!ec);
+      finished = true;
+      conn->cancel();
+   }));
+
+   wb.set("write-behind-cancel", "a");
+
+   // Runs after the flush has started.
+   net::post(ioc, [&]() { sig.emit(net::cancellation_type::terminal); });
+
+   run(conn);
+   ioc.run();
+
+   BOOST_TEST(finished);
+   BOOST_CHECK_EQUAL(wb.pending(), 0u);
+}
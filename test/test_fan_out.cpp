@@ -0,0 +1,123 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/fan_out.hpp>
+#define BOOST_TEST_MODULE fan_out
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using boost::redis::fan_out;
+using boost::redis::detail::spsc_queue;
+
+BOOST_AUTO_TEST_CASE(spsc_bounded)
+{
+   spsc_queue<int> q{3};
+   BOOST_CHECK_EQUAL(q.capacity(), 4u);
+
+   for (int i = 0; i < 4; ++i)
+      BOOST_TEST(q.try_push(i));
+   BOOST_TEST(!q.try_push(4));
+
+   int v = -1;
+   BOOST_TEST(q.try_pop(v));
+   BOOST_CHECK_EQUAL(v, 0);
+   BOOST_TEST(q.try_push(4));
+
+   for (int i = 1; i < 5; ++i) {
+      BOOST_TEST(q.try_pop(v));
+      BOOST_CHECK_EQUAL(v, i);
+   }
+
+   BOOST_TEST(!q.try_pop(v));
+}
+
+BOOST_AUTO_TEST_CASE(shared_message)
+{
+   fan_out fo;
+   auto& a = fo.add_consumer();
+   auto& b = fo.add_consumer();
+   fo("channel", "payload");
+
+   fan_out::message_ptr ma, mb;
+   BOOST_TEST(a.try_pop(ma));
+   BOOST_TEST(b.try_pop(mb));
+   BOOST_CHECK_EQUAL(ma.get(), mb.get());
+   BOOST_CHECK_EQUAL(ma->channel(), "channel");
+   BOOST_CHECK_EQUAL(ma->payload(), "payload");
+}
+
+BOOST_AUTO_TEST_CASE(slow_consumer_drops)
+{
+   fan_out fo;
+   auto& fast = fo.add_consumer(8);
+   auto& slow = fo.add_consumer(2);
+
+   fan_out::message_ptr msg;
+   for (int i = 0; i < 4; ++i) {
+      fo("ch", std::to_string(i));
+      BOOST_TEST(fast.try_pop(msg));
+   }
+
+   BOOST_CHECK_EQUAL(fast.dropped(), 0u);
+   BOOST_CHECK_EQUAL(slow.dropped(), 2u);
+
+   // Keeps the oldest messages.
+   BOOST_TEST(slow.try_pop(msg));
+   BOOST_CHECK_EQUAL(msg->payload(), "0");
+}
+
+BOOST_AUTO_TEST_CASE(threads)
+{
+   constexpr int n = 100000;
+   constexpr std::size_t capacity = 64;
+   fan_out fo;
+   std::vector<fan_out::consumer*> consumers;
+   for (int i = 0; i < 4; ++i)
+      consumers.push_back(&fo.add_consumer(capacity));
+
+   // Boost.Test assertions are not thread-safe, results are checked
+   // after join.
+   std::vector<int> received(std::size(consumers));
+   std::vector<int> in_order(std::size(consumers), 1);
+   std::vector<std::thread> threads;
+   for (std::size_t i = 0; i < std::size(consumers); ++i) {
+      threads.emplace_back([&, i] {
+         fan_out::message_ptr msg;
+         int last = -1;
+         while (last != n - 1) {
+            if (!consumers[i]->try_pop(msg))
+               continue;
+
+            auto const v = std::stoi(std::string{msg->payload()});
+            if (v <= last)
+               in_order[i] = 0;
+            last = v;
+            ++received[i];
+         }
+      });
+   }
+
+   // The last message is retried so that every consumer sees it.
+   for (int i = 0; i < n - 1; ++i)
+      fo("ch", std::to_string(i));
+
+   for (auto* c : consumers) {
+      while (c->size() == capacity)
+         std::this_thread::yield();
+   }
+   fo("ch", std::to_string(n - 1));
+
+   for (auto& t : threads)
+      t.join();
+
+   for (std::size_t i = 0; i < std::size(consumers); ++i) {
+      BOOST_TEST(in_order[i]);
+      BOOST_CHECK_EQUAL(received[i] + consumers[i]->dropped(), std::size_t{n});
+   }
+}
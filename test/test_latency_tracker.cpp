@@ -0,0 +1,66 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/latency_tracker.hpp>
+#define BOOST_TEST_MODULE latency_tracker
+#include <boost/test/included/unit_test.hpp>
+
+using boost::redis::detail::latency_tracker;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+   latency_tracker t;
+   BOOST_TEST((t.get_average() == 0us));
+   BOOST_TEST((t.get_percentile(0.99) == 0us));
+   BOOST_CHECK_EQUAL(t.get_samples(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(percentiles)
+{
+   latency_tracker t;
+
+   // 99 fast requests and a slow one.
+   for (int i = 0; i < 99; ++i)
+      t.add(200us);
+   t.add(50ms);
+
+   BOOST_CHECK_EQUAL(t.get_samples(), 100u);
+
+   // Upper bounds of the power-of-two buckets.
+   BOOST_TEST((t.get_percentile(0.5) == 256us));
+   BOOST_TEST((t.get_percentile(0.98) == 256us));
+   BOOST_TEST((t.get_percentile(1.0) == 65536us));
+}
+
+BOOST_AUTO_TEST_CASE(recent_latencies)
+{
+   latency_tracker t;
+
+   // A slow period followed by a fast one, the slow samples decay.
+   for (std::uint64_t i = 0; i < latency_tracker::window; ++i)
+      t.add(50ms);
+   BOOST_TEST((t.get_percentile(0.5) == 65536us));
+
+   for (std::uint64_t i = 0; i < 4 * latency_tracker::window; ++i)
+      t.add(200us);
+
+   BOOST_CHECK_EQUAL(t.get_samples(), 5 * latency_tracker::window);
+   BOOST_TEST((t.get_percentile(0.95) == 256us));
+}
+
+BOOST_AUTO_TEST_CASE(average)
+{
+   latency_tracker t;
+   t.add(1ms);
+   BOOST_TEST((t.get_average() == 1ms));
+
+   t.add(9ms);
+   BOOST_TEST((t.get_average() == 2ms));
+
+   t.reset();
+   BOOST_CHECK_EQUAL(t.get_samples(), 0u);
+}
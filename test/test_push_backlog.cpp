@@ -0,0 +1,146 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/push_backlog.hpp>
+#define BOOST_TEST_MODULE push_backlog
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+
+using boost::redis::config;
+using boost::redis::push_backlog_policy;
+using boost::redis::detail::push_backlog;
+using boost::redis::resp3::type;
+
+namespace
+{
+
+push_backlog make_backlog(push_backlog_policy policy, std::size_t max)
+{
+   config cfg;
+   cfg.push_backlog = policy;
+   cfg.max_push_backlog = max;
+   push_backlog b;
+   b.set_config(cfg);
+   return b;
+}
+
+push_backlog::nodes_type make_message(std::string channel, std::string payload)
+{
+   return
+      { {type::push, 3, 0, ""}
+      , {type::blob_string, 1, 1, "message"}
+      , {type::blob_string, 1, 1, std::move(channel)}
+      , {type::blob_string, 1, 1, std::move(payload)}
+      };
+}
+
+push_backlog::nodes_type make_pmessage(std::string pattern, std::string channel, std::string payload)
+{
+   return
+      { {type::push, 4, 0, ""}
+      , {type::blob_string, 1, 1, "pmessage"}
+      , {type::blob_string, 1, 1, std::move(pattern)}
+      , {type::blob_string, 1, 1, std::move(channel)}
+      , {type::blob_string, 1, 1, std::move(payload)}
+      };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(block_is_disabled)
+{
+   auto b = make_backlog(push_backlog_policy::block, 10);
+   BOOST_TEST(!b.is_enabled());
+}
+
+BOOST_AUTO_TEST_CASE(drop_oldest)
+{
+   auto b = make_backlog(push_backlog_policy::drop_oldest, 2);
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "2"), 2), 0u);
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "3"), 3), 1u);
+   BOOST_CHECK_EQUAL(b.size(), 2u);
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "2");
+   BOOST_CHECK_EQUAL(b.front().size, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(drop_newest)
+{
+   auto b = make_backlog(push_backlog_policy::drop_newest, 2);
+   b.add(make_message("a", "1"), 1);
+   b.add(make_message("a", "2"), 2);
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "3"), 3), 1u);
+   BOOST_CHECK_EQUAL(b.size(), 2u);
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "1");
+   b.pop_front();
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "2");
+}
+
+BOOST_AUTO_TEST_CASE(conflate)
+{
+   auto b = make_backlog(push_backlog_policy::conflate, 10);
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.add(make_message("b", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "2"), 1), 1u);
+   BOOST_CHECK_EQUAL(b.size(), 2u);
+
+   // Replaced in place.
+   BOOST_CHECK_EQUAL(b.front().nodes[2].value, "a");
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "2");
+   b.pop_front();
+   BOOST_CHECK_EQUAL(b.front().nodes[2].value, "b");
+   b.pop_front();
+   BOOST_TEST(b.empty());
+
+   // A delivered channel is conflated again from scratch.
+   BOOST_CHECK_EQUAL(b.add(make_message("a", "3"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(conflate_by_kind_and_pattern)
+{
+   auto b = make_backlog(push_backlog_policy::conflate, 10);
+
+   // The same channel received through a subscription and two
+   // patterns is three different streams.
+   BOOST_CHECK_EQUAL(b.add(make_message("a.b", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.add(make_pmessage("a.*", "a.b", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.add(make_pmessage("*.b", "a.b", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(b.size(), 3u);
+
+   BOOST_CHECK_EQUAL(b.add(make_pmessage("a.*", "a.b", "2"), 1), 1u);
+   BOOST_CHECK_EQUAL(b.size(), 3u);
+
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "1");
+   b.pop_front();
+   BOOST_CHECK_EQUAL(b.front().nodes[2].value, "a.*");
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "2");
+   b.pop_front();
+   BOOST_CHECK_EQUAL(b.front().nodes[2].value, "*.b");
+   BOOST_CHECK_EQUAL(b.front().nodes.back().value, "1");
+
+   // Pattern and channel don't run into each other.
+   auto c = make_backlog(push_backlog_policy::conflate, 10);
+   c.add(make_pmessage("ab", "c", "1"), 1);
+   BOOST_CHECK_EQUAL(c.add(make_pmessage("a", "bc", "1"), 1), 0u);
+   BOOST_CHECK_EQUAL(c.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(conflate_other_pushes)
+{
+   auto b = make_backlog(push_backlog_policy::conflate, 10);
+   push_backlog::nodes_type sub =
+      { {type::push, 3, 0, ""}
+      , {type::blob_string, 1, 1, "subscribe"}
+      , {type::blob_string, 1, 1, "a"}
+      , {type::number, 1, 1, "1"}
+      };
+
+   b.add(sub, 1);
+   BOOST_CHECK_EQUAL(b.add(sub, 1), 0u);
+   BOOST_CHECK_EQUAL(b.size(), 2u);
+}
@@ -0,0 +1,118 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/read_fuser.hpp>
+#include <boost/redis/request.hpp>
+#define BOOST_TEST_MODULE read_fuser
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+
+using boost::redis::config;
+using boost::redis::request;
+using boost::redis::detail::read_fuser;
+
+namespace
+{
+
+read_fuser make_fuser(std::size_t max)
+{
+   config cfg;
+   cfg.read_fusion_max_requests = max;
+   read_fuser f;
+   f.set_config(cfg);
+   return f;
+}
+
+request make_request(std::string_view cmd, std::string_view key)
+{
+   request req;
+   req.push(cmd, key);
+   return req;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+   BOOST_TEST(!make_fuser(0).is_enabled());
+   BOOST_TEST(!make_fuser(1).is_enabled());
+   BOOST_TEST(make_fuser(2).is_enabled());
+}
+
+BOOST_AUTO_TEST_CASE(gets_to_mget)
+{
+   auto f = make_fuser(16);
+   auto const r1 = make_request("GET", "a");
+   auto const r2 = make_request("get", "bc");
+
+   BOOST_TEST(f.try_add(r1.payload()));
+   BOOST_TEST(f.try_add(r2.payload()));
+
+   std::string payload;
+   BOOST_CHECK_EQUAL(f.flush(payload), 2u);
+   BOOST_CHECK_EQUAL(payload, "*3\r\n$4\r\nMGET\r\n$1\r\na\r\n$2\r\nbc\r\n");
+   BOOST_CHECK_EQUAL(f.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(hgets_to_hmget)
+{
+   auto f = make_fuser(16);
+   request r1;
+   r1.push("HGET", "h", "f1");
+   request r2;
+   r2.push("HGET", "h", "f2");
+   request r3;
+   r3.push("HGET", "other", "f3");
+
+   BOOST_TEST(f.try_add(r1.payload()));
+   BOOST_TEST(f.try_add(r2.payload()));
+
+   // Different key.
+   BOOST_TEST(!f.try_add(r3.payload()));
+
+   std::string payload;
+   BOOST_CHECK_EQUAL(f.flush(payload), 2u);
+   BOOST_CHECK_EQUAL(payload, "*4\r\n$5\r\nHMGET\r\n$1\r\nh\r\n$2\r\nf1\r\n$2\r\nf2\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(single_is_unchanged)
+{
+   auto f = make_fuser(16);
+   auto const r1 = make_request("GET", "a");
+   BOOST_TEST(f.try_add(r1.payload()));
+
+   std::string payload;
+   BOOST_CHECK_EQUAL(f.flush(payload), 1u);
+   BOOST_CHECK_EQUAL(payload, r1.payload());
+}
+
+BOOST_AUTO_TEST_CASE(not_fusible)
+{
+   auto f = make_fuser(2);
+
+   // Not a single GET.
+   request r1;
+   r1.push("GET", "a");
+   r1.push("GET", "b");
+   BOOST_TEST(!f.try_add(r1.payload()));
+   BOOST_TEST(!f.try_add(make_request("SET", "a").payload()));
+   BOOST_TEST(!f.try_add(make_request("EXISTS", "a").payload()));
+
+   // Full.
+   auto const r2 = make_request("GET", "a");
+   BOOST_TEST(f.try_add(r2.payload()));
+   BOOST_TEST(f.try_add(r2.payload()));
+   BOOST_TEST(!f.try_add(r2.payload()));
+
+   // GET and HGET are not fused.
+   std::string payload;
+   f.flush(payload);
+   request r3;
+   r3.push("HGET", "a", "b");
+   BOOST_TEST(f.try_add(r2.payload()));
+   BOOST_TEST(!f.try_add(r3.payload()));
+}
@@ -4,6 +4,7 @@
  * accompanying file LICENSE.txt)
  */
 
+#include <array>
 #include <iostream>
 
 #define BOOST_TEST_MODULE request
@@ -51,3 +52,91 @@ BOOST_AUTO_TEST_CASE(container_and_range)
    req2.push_range("HSET", "key", std::cbegin(in), std::cend(in));
    BOOST_CHECK_EQUAL(req2.payload(), std::string{res});
 }
+
+BOOST_AUTO_TEST_CASE(append)
+{
+   request req1;
+   req1.push("PING");
+
+   request req2;
+   req2.push("HELLO", 3);
+   req2.push("SUBSCRIBE", "channel");
+
+   req1.append(req2);
+
+   char const* res = "*1\r\n$4\r\nPING\r\n*2\r\n$5\r\nHELLO\r\n$1\r\n3\r\n*2\r\n$9\r\nSUBSCRIBE\r\n$7\r\nchannel\r\n";
+   BOOST_CHECK_EQUAL(req1.payload(), std::string{res});
+   BOOST_CHECK_EQUAL(req1.get_commands(), 3u);
+   BOOST_CHECK_EQUAL(req1.get_expected_responses(), 2u);
+   BOOST_TEST(req1.has_hello_priority());
+}
+
+BOOST_AUTO_TEST_CASE(read_only)
+{
+   request req;
+   BOOST_TEST(!req.is_read_only());
+
+   req.push("GET", "key");
+   req.push("hgetall", "key");
+   BOOST_TEST(req.is_read_only());
+
+   req.push("SET", "key", "value");
+   BOOST_TEST(!req.is_read_only());
+
+   req.clear();
+   req.push("ZRANGEBYSCORE", "key", 0, 1);
+   BOOST_TEST(req.is_read_only());
+
+   request req2;
+   req2.push("INCR", "key");
+   req.append(req2);
+   BOOST_TEST(!req.is_read_only());
+}
+
+BOOST_AUTO_TEST_CASE(blocking)
+{
+   request req;
+   req.push("GET", "key");
+   BOOST_TEST(!req.is_blocking());
+
+   req.push("blpop", "key", 0);
+   BOOST_TEST(req.is_blocking());
+
+   req.clear();
+   req.push("XREAD", "COUNT", 10, "STREAMS", "BLOCK", 0);
+   BOOST_TEST(!req.is_blocking());
+
+   req.push("XREAD", "block", 0, "STREAMS", "key", "$");
+   BOOST_TEST(req.is_blocking());
+
+   request req2;
+   req2.push("PING");
+   req2.append(req);
+   BOOST_TEST(req2.is_blocking());
+}
+
+BOOST_AUTO_TEST_CASE(no_reply)
+{
+   request req;
+   req.push("PING");
+   req.get_config().no_reply = true;
+   req.push("INCRBY", "key", 1);
+
+   char const* res = "*1\r\n$4\r\nPING\r\n*3\r\n$6\r\nCLIENT\r\n$5\r\nREPLY\r\n$4\r\nSKIP\r\n*3\r\n$6\r\nINCRBY\r\n$3\r\nkey\r\n$1\r\n1\r\n";
+   BOOST_CHECK_EQUAL(req.payload(), std::string{res});
+   BOOST_CHECK_EQUAL(req.get_commands(), 2u);
+   BOOST_CHECK_EQUAL(req.get_expected_responses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(evalsha)
+{
+   std::array<std::string, 2> keys{"a", "b"};
+   std::array<int, 1> args{10};
+
+   request req;
+   req.push_evalsha("sha", keys, args);
+
+   char const* res = "*6\r\n$7\r\nEVALSHA\r\n$3\r\nsha\r\n$1\r\n2\r\n$1\r\na\r\n$1\r\nb\r\n$2\r\n10\r\n";
+   BOOST_CHECK_EQUAL(req.payload(), std::string{res});
+   BOOST_CHECK_EQUAL(req.get_expected_responses(), 1u);
+}
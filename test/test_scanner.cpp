@@ -0,0 +1,303 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/scanner.hpp>
+#include <boost/redis/detail/scan_page.hpp>
+#define BOOST_TEST_MODULE scanner
+#include <boost/test/included/unit_test.hpp>
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace net = boost::asio;
+using boost::redis::basic_scanner;
+using boost::redis::request;
+using boost::redis::detail::scan_page;
+using boost::redis::detail::scan_page_adapter;
+using node_type = boost::redis::resp3::basic_node<std::string_view>;
+using boost::redis::resp3::type;
+using error_code = boost::system::error_code;
+
+namespace
+{
+
+// Stands in for a connection, pages are completed by the test.
+class fake_connection {
+public:
+   using executor_type = net::io_context::executor_type;
+
+   explicit fake_connection(net::io_context& ioc)
+   : ex_{ioc.get_executor()}
+   { }
+
+   template <class CompletionToken>
+   void async_exec(request const& req, scan_page& page, CompletionToken&& token)
+   {
+      auto slot = net::get_associated_cancellation_slot(token);
+      fetches_.push_back({std::string{req.payload()}, &page, std::forward<CompletionToken>(token), slot});
+
+      if (slot.is_connected()) {
+         // Only one fetch per partition is in flight.
+         slot.assign([this](net::cancellation_type) {
+            net::post(ex_, [this]() { complete_with(net::error::operation_aborted); });
+         });
+      }
+   }
+
+   // Completes the oldest fetch with a page.
+   void complete(std::string cursor, std::vector<std::string> const& elements)
+   {
+      auto& page = *fetches_.front().page;
+      page.cursor = std::move(cursor);
+      for (auto const& e : elements) {
+         if (page.size < std::size(page.elements))
+            page.elements[page.size] = e;
+         else
+            page.elements.push_back(e);
+         ++page.size;
+      }
+
+      complete_with({});
+   }
+
+   void complete_with(error_code ec)
+   {
+      auto f = std::move(fetches_.front());
+      fetches_.pop_front();
+      if (f.slot.is_connected())
+         f.slot.clear();
+
+      net::post(ex_, [h = std::move(f.handler), ec]() mutable { h(ec, 0); });
+   }
+
+   // Payload of the oldest fetch.
+   auto const& front_payload() const
+      { return fetches_.front().payload; }
+
+   auto pending() const noexcept
+      { return std::size(fetches_); }
+
+private:
+   struct fetch {
+      std::string payload;
+      scan_page* page;
+      std::function<void(error_code, std::size_t)> handler;
+      net::cancellation_slot slot;
+   };
+
+   executor_type ex_;
+   std::deque<fetch> fetches_;
+};
+
+using scanner_type = basic_scanner<fake_connection>;
+
+struct next_result {
+   bool done = false;
+   error_code ec;
+   std::size_t size = 0;
+};
+
+void next(scanner_type& s, next_result& r)
+{
+   r = {};
+   s.async_next([&r](error_code ec, std::size_t n) {
+      r.done = true;
+      r.ec = ec;
+      r.size = n;
+   });
+}
+
+std::vector<std::string> keys_of(scanner_type const& s)
+{
+   auto const keys = s.get_keys();
+   return {keys.begin(), keys.end()};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(page_adapter)
+{
+   scan_page page;
+   scan_page_adapter adapter{page};
+
+   error_code ec;
+   adapter(0, node_type{type::array, 2, 0, ""}, ec);
+   adapter(0, node_type{type::blob_string, 1, 1, "17"}, ec);
+   adapter(0, node_type{type::array, 3, 1, ""}, ec);
+   adapter(0, node_type{type::blob_string, 1, 2, "a"}, ec);
+   adapter(0, node_type{type::blob_string, 1, 2, "b"}, ec);
+   adapter(0, node_type{type::blob_string, 1, 2, "c"}, ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(page.cursor, "17");
+   BOOST_CHECK_EQUAL(page.size, 3u);
+   BOOST_CHECK_EQUAL(page.elements.at(2), "c");
+
+   // The strings of the previous page are reused.
+   page.clear();
+   adapter(0, node_type{type::array, 2, 0, ""}, ec);
+   adapter(0, node_type{type::blob_string, 1, 1, "0"}, ec);
+   adapter(0, node_type{type::array, 1, 1, ""}, ec);
+   adapter(0, node_type{type::blob_string, 1, 2, "d"}, ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(page.cursor, "0");
+   BOOST_CHECK_EQUAL(page.size, 1u);
+   BOOST_CHECK_EQUAL(std::size(page.elements), 3u);
+   BOOST_CHECK_EQUAL(page.elements.at(0), "d");
+}
+
+BOOST_AUTO_TEST_CASE(page_adapter_error)
+{
+   scan_page page;
+   scan_page_adapter adapter{page};
+
+   error_code ec;
+   adapter(0, node_type{type::simple_error, 1, 0, "ERR invalid cursor"}, ec);
+   BOOST_CHECK_EQUAL(ec, boost::redis::error::resp3_simple_error);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch)
+{
+   net::io_context ioc;
+   fake_connection conn{ioc};
+   scanner_type s{ioc.get_executor(), "SCAN", {}, 2};
+   s.add_partition(conn, "user:*");
+
+   next_result r;
+   next(s, r);
+   ioc.poll();
+   BOOST_TEST(!r.done);
+   BOOST_CHECK_EQUAL(conn.pending(), 1u);
+   BOOST_TEST(conn.front_payload().find("SCAN\r\n$1\r\n0\r\n") != std::string::npos);
+
+   conn.complete("5", {"user:1", "user:2"});
+   ioc.poll();
+   BOOST_TEST(r.done);
+   BOOST_TEST(!r.ec);
+   BOOST_CHECK_EQUAL(r.size, 2u);
+
+   // The next page is fetched while this one is processed.
+   BOOST_CHECK_EQUAL(conn.pending(), 1u);
+   BOOST_TEST(conn.front_payload().find("\r\n5\r\n") != std::string::npos);
+
+   // No more than one page ahead of the application, and the current
+   // page is not overwritten.
+   conn.complete("9", {"user:3"});
+   ioc.poll();
+   BOOST_CHECK_EQUAL(conn.pending(), 0u);
+   std::vector<std::string> const expected1{"user:1", "user:2"};
+   BOOST_TEST(keys_of(s) == expected1, boost::test_tools::per_element());
+
+   next(s, r);
+   ioc.poll();
+   BOOST_TEST(r.done);
+   BOOST_CHECK_EQUAL(r.size, 1u);
+   BOOST_CHECK_EQUAL(conn.pending(), 1u);
+   std::vector<std::string> const expected2{"user:3"};
+   BOOST_TEST(keys_of(s) == expected2, boost::test_tools::per_element());
+
+   conn.complete("0", {});
+   next(s, r);
+   ioc.poll();
+   BOOST_TEST(r.done);
+   BOOST_CHECK_EQUAL(r.size, 0u);
+   BOOST_TEST(s.is_done());
+}
+
+BOOST_AUTO_TEST_CASE(round_robin)
+{
+   net::io_context ioc;
+   fake_connection conn1{ioc};
+   fake_connection conn2{ioc};
+   scanner_type s{ioc.get_executor(), "SCAN", {}, 2};
+   s.add_partition(conn1, "a:*");
+   s.add_partition(conn2, {}, "hash");
+
+   next_result r;
+   next(s, r);
+   ioc.poll();
+
+   // All partitions are fetched concurrently, each with its filters.
+   BOOST_CHECK_EQUAL(conn1.pending(), 1u);
+   BOOST_CHECK_EQUAL(conn2.pending(), 1u);
+   BOOST_TEST(conn1.front_payload().find("MATCH\r\n$3\r\na:*") != std::string::npos);
+   BOOST_TEST(conn1.front_payload().find("COUNT\r\n$1\r\n2") != std::string::npos);
+   BOOST_TEST(conn2.front_payload().find("TYPE\r\n$4\r\nhash") != std::string::npos);
+
+   // Pages are returned as they arrive.
+   conn2.complete("3", {"h1"});
+   ioc.poll();
+   BOOST_TEST(r.done);
+   std::vector<std::string> const expected1{"h1"};
+   BOOST_TEST(keys_of(s) == expected1, boost::test_tools::per_element());
+
+   // With pages ready on both, the partition after the last one goes first.
+   conn1.complete("0", {"a:1", "a:2"});
+   conn2.complete("0", {"h2"});
+   ioc.poll();
+
+   next(s, r);
+   ioc.poll();
+   BOOST_TEST(r.done);
+   std::vector<std::string> const expected2{"a:1", "a:2"};
+   BOOST_TEST(keys_of(s) == expected2, boost::test_tools::per_element());
+   BOOST_TEST(!s.is_done());
+
+   next(s, r);
+   ioc.poll();
+   BOOST_TEST(r.done);
+   std::vector<std::string> const expected3{"h2"};
+   BOOST_TEST(keys_of(s) == expected3, boost::test_tools::per_element());
+
+   BOOST_CHECK_EQUAL(conn1.pending(), 0u);
+   BOOST_CHECK_EQUAL(conn2.pending(), 0u);
+   BOOST_TEST(s.is_done());
+}
+
+BOOST_AUTO_TEST_CASE(cancel)
+{
+   net::io_context ioc;
+   fake_connection conn{ioc};
+   scanner_type s{ioc.get_executor()};
+   s.add_partition(conn);
+
+   next_result r;
+   next(s, r);
+   ioc.poll();
+   BOOST_CHECK_EQUAL(conn.pending(), 1u);
+   BOOST_TEST(!s.is_done());
+
+   s.cancel();
+   ioc.poll();
+
+   // The fetch in flight is cancelled too.
+   BOOST_TEST(r.done);
+   BOOST_CHECK_EQUAL(r.ec, net::error::operation_aborted);
+   BOOST_CHECK_EQUAL(conn.pending(), 0u);
+   BOOST_TEST(s.is_done());
+}
+
+BOOST_AUTO_TEST_CASE(fetch_error)
+{
+   net::io_context ioc;
+   fake_connection conn{ioc};
+   scanner_type s{ioc.get_executor()};
+   s.add_partition(conn);
+
+   next_result r;
+   next(s, r);
+   ioc.poll();
+
+   conn.complete_with(boost::redis::error::resp3_simple_error);
+   ioc.poll();
+
+   BOOST_TEST(r.done);
+   BOOST_CHECK_EQUAL(r.ec, boost::redis::error::resp3_simple_error);
+   BOOST_TEST(s.is_done());
+}
@@ -0,0 +1,108 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/script.hpp>
+#include <boost/redis/response.hpp>
+#define BOOST_TEST_MODULE script
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+
+using boost::redis::config;
+using boost::redis::script;
+using boost::redis::script_registry;
+using boost::redis::detail::sha1_hex;
+using boost::redis::detail::evalsha_response;
+using boost::redis::adapter::boost_redis_adapt;
+using boost::redis::response;
+using boost::redis::resp3::type;
+using node_type = boost::redis::resp3::basic_node<std::string_view>;
+using error_code = boost::system::error_code;
+
+BOOST_AUTO_TEST_CASE(sha1)
+{
+   BOOST_CHECK_EQUAL(sha1_hex(""), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+   BOOST_CHECK_EQUAL(sha1_hex("abc"), "a9993e364706816aba3e25717850c26c9cd0d89d");
+
+   // Padding spills into a second block.
+   BOOST_CHECK_EQUAL(sha1_hex(std::string(56, 'a')), "c2db330f6083854c99d4b5bfb6e8f29f201be699");
+   BOOST_CHECK_EQUAL(sha1_hex(std::string(1000, 'a')), "291e9a6c66994949b57ba5e650361e98fc36b1ba");
+}
+
+BOOST_AUTO_TEST_CASE(script_digest)
+{
+   script s{"return 1"};
+   BOOST_CHECK_EQUAL(s.body(), "return 1");
+   BOOST_CHECK_EQUAL(s.sha1(), "e0e1f9fabfc9d4800c877a703b823ac0578ff8db");
+}
+
+BOOST_AUTO_TEST_CASE(registry_preload)
+{
+   script_registry reg;
+   auto const& s1 = reg.add("return 1");
+   auto const& s2 = reg.add("return 1");
+   reg.add("return 2");
+   BOOST_CHECK_EQUAL(&s1, &s2);
+   BOOST_CHECK_EQUAL(reg.size(), 2u);
+
+   config cfg;
+   reg.preload(cfg);
+   BOOST_CHECK_EQUAL(cfg.setup.get_commands(), 2u);
+   BOOST_CHECK_EQUAL(
+      cfg.setup.payload(),
+      "*3\r\n$6\r\nSCRIPT\r\n$4\r\nLOAD\r\n$8\r\nreturn 1\r\n"
+      "*3\r\n$6\r\nSCRIPT\r\n$4\r\nLOAD\r\n$8\r\nreturn 2\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(registry_preload_twice)
+{
+   script_registry reg;
+   reg.add("return 1");
+
+   config cfg;
+   reg.preload(cfg);
+   reg.preload(cfg);
+   BOOST_CHECK_EQUAL(cfg.setup.get_commands(), 1u);
+
+   reg.add("return 2");
+   reg.preload(cfg);
+   BOOST_CHECK_EQUAL(cfg.setup.get_commands(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(load_error_is_passed)
+{
+   response<std::string> resp;
+   using adapter_type = decltype(boost_redis_adapt(resp));
+   evalsha_response<adapter_type> r{boost_redis_adapt(resp)};
+   r.skip = 1;
+   r.intercept = false;
+
+   // The retry: SCRIPT LOAD fails, EVALSHA can only respond NOSCRIPT.
+   auto adapter = boost_redis_adapt(r);
+   error_code ec;
+   adapter(0, node_type{type::simple_error, 1, 0, "ERR Error compiling script"}, ec);
+   adapter(1, node_type{type::simple_error, 1, 0, "NOSCRIPT No matching script."}, ec);
+
+   BOOST_TEST(!std::get<0>(resp).has_value());
+   BOOST_CHECK_EQUAL(std::get<0>(resp).error().diagnostic, "ERR Error compiling script");
+}
+
+BOOST_AUTO_TEST_CASE(load_success_is_skipped)
+{
+   response<std::string> resp;
+   using adapter_type = decltype(boost_redis_adapt(resp));
+   evalsha_response<adapter_type> r{boost_redis_adapt(resp)};
+   r.skip = 1;
+   r.intercept = false;
+
+   auto adapter = boost_redis_adapt(r);
+   error_code ec;
+   adapter(0, node_type{type::blob_string, 1, 0, "e0e1f9fabfc9d4800c877a703b823ac0578ff8db"}, ec);
+   adapter(1, node_type{type::blob_string, 1, 0, "ab"}, ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "ab");
+}
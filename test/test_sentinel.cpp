@@ -0,0 +1,99 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/sentinel.hpp>
+#define BOOST_TEST_MODULE sentinel
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+using boost::redis::address;
+using boost::redis::config;
+using boost::redis::detail::find_switch_master;
+using boost::redis::detail::make_sentinel_config;
+using boost::redis::resp3::node;
+using boost::redis::resp3::type;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+void push_message(std::vector<node>& nodes, std::string channel, std::string payload)
+{
+   nodes.push_back({type::push, 3, 0, ""});
+   nodes.push_back({type::blob_string, 1, 1, "message"});
+   nodes.push_back({type::blob_string, 1, 1, std::move(channel)});
+   nodes.push_back({type::blob_string, 1, 1, std::move(payload)});
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(sentinel_config)
+{
+   config cfg;
+   cfg.addr = address{"master", "6379"};
+   cfg.use_ssl = true;
+   cfg.username = "user";
+   cfg.password = "pass";
+   cfg.database_index = 2;
+   cfg.setup.push("CLIENT", "NO-EVICT", "on");
+   cfg.sentinel.addresses = {address{"s1", "26379"}, address{"s2", "26380"}};
+   cfg.sentinel.username = "suser";
+   cfg.sentinel.password = "spass";
+
+   auto const ret = make_sentinel_config(cfg, 1);
+   BOOST_CHECK_EQUAL(ret.addr.host, "s2");
+   BOOST_CHECK_EQUAL(ret.addr.port, "26380");
+   BOOST_TEST(ret.sentinel.addresses.empty());
+   BOOST_CHECK_EQUAL(ret.username, "suser");
+   BOOST_CHECK_EQUAL(ret.password, "spass");
+   BOOST_TEST(!ret.database_index.has_value());
+   BOOST_TEST(!ret.use_ssl);
+   BOOST_TEST((ret.health_check_interval == 0s));
+   BOOST_CHECK_EQUAL(ret.setup.get_commands(), 0u);
+
+   BOOST_CHECK_THROW(make_sentinel_config(cfg, 2), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(switch_master)
+{
+   std::vector<node> nodes;
+   push_message(nodes, "+switch-master", "mymaster 10.0.0.1 6379 10.0.0.2 6380");
+
+   auto const ret = find_switch_master(nodes, "mymaster");
+   BOOST_TEST(ret.has_value());
+   BOOST_CHECK_EQUAL(ret->host, "10.0.0.2");
+   BOOST_CHECK_EQUAL(ret->port, "6380");
+}
+
+BOOST_AUTO_TEST_CASE(switch_master_last_wins)
+{
+   std::vector<node> nodes;
+   push_message(nodes, "+switch-master", "mymaster 10.0.0.1 6379 10.0.0.2 6380");
+   push_message(nodes, "+switch-master", "mymaster 10.0.0.2 6380 10.0.0.3 6381");
+
+   auto const ret = find_switch_master(nodes, "mymaster");
+   BOOST_TEST(ret.has_value());
+   BOOST_CHECK_EQUAL(ret->host, "10.0.0.3");
+}
+
+BOOST_AUTO_TEST_CASE(switch_master_ignored)
+{
+   std::vector<node> nodes;
+
+   // Other master, other channel, malformed payload and the
+   // subscription confirmation.
+   push_message(nodes, "+switch-master", "other 10.0.0.1 6379 10.0.0.2 6380");
+   push_message(nodes, "+sdown", "mymaster 10.0.0.1 6379 10.0.0.2 6380");
+   push_message(nodes, "+switch-master", "mymaster 10.0.0.1 6379");
+   nodes.push_back({type::push, 3, 0, ""});
+   nodes.push_back({type::blob_string, 1, 1, "subscribe"});
+   nodes.push_back({type::blob_string, 1, 1, "+switch-master"});
+   nodes.push_back({type::number, 1, 1, "1"});
+
+   BOOST_TEST(!find_switch_master(nodes, "mymaster").has_value());
+}
@@ -0,0 +1,147 @@
+/* Copyright (c) 2018-2024 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/split_merger.hpp>
+#include <boost/redis/splitter.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/redis/response.hpp>
+#define BOOST_TEST_MODULE split_merger
+#include <boost/test/included/unit_test.hpp>
+
+#include <optional>
+#include <utility>
+#include <string>
+#include <vector>
+
+using boost::redis::detail::split_merger;
+using boost::redis::detail::get_split_unit;
+using boost::redis::detail::is_split_option;
+using boost::redis::detail::starts_with_option;
+using boost::redis::detail::command_flags;
+using boost::redis::adapter::boost_redis_adapt;
+using boost::redis::response;
+using boost::redis::generic_response;
+using node_type = boost::redis::resp3::basic_node<std::string_view>;
+using boost::redis::resp3::type;
+using error_code = boost::system::error_code;
+
+template <class Response>
+auto make_merger(Response& resp, command_flags policy, std::size_t total)
+{
+   using adapter_type = decltype(boost_redis_adapt(resp));
+   return split_merger<adapter_type>{boost_redis_adapt(resp), policy, total};
+}
+
+BOOST_AUTO_TEST_CASE(sum)
+{
+   response<std::size_t> resp;
+   auto m = make_merger(resp, command_flags::split_sum, 5);
+
+   error_code ec;
+   m.on_node(node_type{type::number, 1, 0, "3"}, ec);
+   m.on_node(node_type{type::number, 1, 0, "2"}, ec);
+   m.finish(ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(last)
+{
+   response<std::size_t> resp;
+   auto m = make_merger(resp, command_flags::split_last, 5);
+
+   error_code ec;
+   m.on_node(node_type{type::number, 1, 0, "3"}, ec);
+   m.on_node(node_type{type::number, 1, 0, "5"}, ec);
+   m.finish(ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(concat)
+{
+   response<std::vector<std::optional<std::string>>> resp;
+   auto m = make_merger(resp, command_flags::split_concat, 3);
+
+   error_code ec;
+   m.on_node(node_type{type::array, 2, 0, {}}, ec);
+   m.on_node(node_type{type::blob_string, 1, 1, "a"}, ec);
+   m.on_node(node_type{type::null, 1, 1, {}}, ec);
+   m.on_node(node_type{type::array, 1, 0, {}}, ec);
+   m.on_node(node_type{type::blob_string, 1, 1, "c"}, ec);
+   m.finish(ec);
+
+   BOOST_TEST(!ec);
+   auto const& v = std::get<0>(resp).value();
+   BOOST_CHECK_EQUAL(v.size(), 3u);
+   BOOST_CHECK_EQUAL(v.at(0).value(), "a");
+   BOOST_TEST(!v.at(1).has_value());
+   BOOST_CHECK_EQUAL(v.at(2).value(), "c");
+}
+
+BOOST_AUTO_TEST_CASE(ok)
+{
+   response<std::string> resp;
+   auto m = make_merger(resp, command_flags::split_ok, 4);
+
+   error_code ec;
+   m.on_node(node_type{type::simple_string, 1, 0, "OK"}, ec);
+   m.on_node(node_type{type::simple_string, 1, 0, "OK"}, ec);
+   m.finish(ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "OK");
+}
+
+BOOST_AUTO_TEST_CASE(error_ends_merge)
+{
+   generic_response resp;
+   auto m = make_merger(resp, command_flags::split_sum, 4);
+
+   error_code ec;
+   m.on_node(node_type{type::number, 1, 0, "1"}, ec);
+   m.on_node(node_type{type::simple_error, 1, 0, "WRONGTYPE"}, ec);
+
+   BOOST_TEST(m.has_failed());
+   BOOST_TEST(resp.has_error());
+}
+
+BOOST_AUTO_TEST_CASE(split_unit)
+{
+   // Flat ranges of pairs advance two elements per group.
+   BOOST_CHECK_EQUAL(get_split_unit("HSET", 1), 2u);
+   BOOST_CHECK_EQUAL(get_split_unit("MSET", 1), 2u);
+   BOOST_CHECK_EQUAL(get_split_unit("ZADD", 1), 2u);
+
+   // Ranges of std::pair.
+   BOOST_CHECK_EQUAL(get_split_unit("HSET", 2), 1u);
+
+   BOOST_CHECK_EQUAL(get_split_unit("SADD", 1), 1u);
+   BOOST_CHECK_EQUAL(get_split_unit("MGET", 1), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(split_options)
+{
+   BOOST_TEST(is_split_option("ZADD", "NX"));
+   BOOST_TEST(is_split_option("zadd", "ch"));
+   BOOST_TEST(is_split_option("ZADD", "INCR"));
+   BOOST_TEST(!is_split_option("ZADD", "1"));
+   BOOST_TEST(!is_split_option("HSET", "NX"));
+
+   std::vector<std::string> const with_options{"NX", "CH", "1", "a"};
+   BOOST_TEST(starts_with_option("ZADD", std::cbegin(with_options), std::cend(with_options)));
+
+   std::vector<std::string> const pairs{"1", "NX", "2", "CH"};
+   BOOST_TEST(!starts_with_option("ZADD", std::cbegin(pairs), std::cend(pairs)));
+
+   std::vector<int> const numbers{1, 2};
+   BOOST_TEST(!starts_with_option("ZADD", std::cbegin(numbers), std::cend(numbers)));
+
+   std::vector<std::pair<int, std::string>> const members{{1, "NX"}};
+   BOOST_TEST(!starts_with_option("ZADD", std::cbegin(members), std::cend(members)));
+}